@@ -1,109 +1,347 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <array>
+#include <set>
 #include <list>
 #include <memory>
+#include <chrono>
 #include <algorithm>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstdint>
+#include <typeinfo>
+#include <type_traits>
+#include <new>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
 
-// Базовий клас Carriage
+// Вид вагона: компактний тег замість dynamic_cast і порівняння рядків типу.
+// Похідні від наведених класів мають вид свого базового класу; решта - Other.
+enum class CarriageKind : std::uint8_t {
+    Passenger,
+    Freight,
+    Dining,
+    Sleeping,
+    Other
+};
+
+// Допоміжний тип для відвідувачів з набору лямбд (як для std::visit)
+template <typename... Fs>
+struct Overloaded : Fs... {
+    using Fs::operator()...;
+};
+template <typename... Fs>
+Overloaded(Fs...) -> Overloaded<Fs...>;
+
+class Carriage;
+
+// Спостерігач змін вагона: склад (Train) підтримує за ним індекс ID і підсумки
+class CarriageObserver {
+public:
+    virtual ~CarriageObserver() {}
+
+    // Викликається до зміни ID і може відхилити її винятком
+    virtual void beforeIdChange(const Carriage& carriage, const std::string& newId) = 0;
+    virtual void typeChanged(const Carriage& carriage, const std::string& oldType) = 0;
+    virtual void weightChanged(const Carriage& carriage, double oldWeight) = 0;
+    virtual void seatsChanged(const Carriage& carriage, int oldSeats) = 0;
+    virtual void cargoCapacityChanged(const Carriage& carriage, double oldCapacity) = 0;
+
+    // Присвоєння вагону нового значення: до нього склад вилучає старі значення (і може відхилити ID),
+    // після - додає нові
+    virtual void beforeAssign(const Carriage& carriage, const Carriage& source) = 0;
+    virtual void afterAssign(const Carriage& carriage) = 0;
+};
+
+// Посилання на спостерігача: переноситься при переміщенні вагона (всередині складу),
+// але не копіюється, тож копія вагона поза складом не змінює його підсумків.
+// Присвоєння не змінює спостерігача: вагон лишається у своєму складі.
+class ObserverLink {
+public:
+    ObserverLink() : observer(nullptr) {}
+    ObserverLink(const ObserverLink&) : observer(nullptr) {}
+    ObserverLink(ObserverLink&& other) noexcept : observer(other.observer) {}
+    ObserverLink& operator=(const ObserverLink&) { return *this; }
+    ObserverLink& operator=(ObserverLink&&) noexcept { return *this; }
+
+    CarriageObserver* observer;
+};
+
+// Пул рядків: повторювані значення (тип, власник, колір, матеріал, ...) зберігаються один раз,
+// вагон тримає лише вказівник. Значення не видаляються, тож вказівники стабільні.
+class StringPool {
+    mutable std::shared_mutex mutex;
+    std::deque<std::string> values;
+    std::unordered_map<std::string_view, const std::string*> lookup;
+
+public:
+    static StringPool& global() {
+        static StringPool pool;
+        return pool;
+    }
+
+    const std::string* intern(std::string_view value) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = lookup.find(value);
+            if (it != lookup.end()) {
+                return it->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = lookup.find(value);
+        if (it != lookup.end()) {
+            return it->second;
+        }
+        values.emplace_back(value);
+        lookup.emplace(values.back(), &values.back());
+        return &values.back();
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return values.size();
+    }
+};
+
+// Рядок з глобального пулу: вісім байтів замість std::string у кожному вагоні
+class InternedString {
+public:
+    InternedString() : value(empty()) {}
+    InternedString(std::string_view value) : value(StringPool::global().intern(value)) {}
+
+    const std::string& str() const { return *value; }
+
+private:
+    static const std::string* empty() {
+        static const std::string* value = StringPool::global().intern("");
+        return value;
+    }
+
+    const std::string* value;
+};
+
+// Рідко вживані поля вагона, які не потрібні для підсумків складу.
+// Інтернуються лише значення з малого набору; дати й станції часто змінюються,
+// тож у пулі, який нічого не звільняє, вони накопичувалися б без меж.
+struct CarriageDetails {
+    InternedString owner;
+    InternedString color;
+    InternedString material;
+    std::string manufactureDate;
+    std::string maintenanceDate;
+    std::string lastStation;
+    double energyConsumption = 0;
+    double manufacturingCost = 0;
+    int maxSpeed = 0;
+    int currentPassengers = 0;
+    bool inService = false;
+};
+
+// Деталі вагона виділяються лише при першому записі; до того читаються значення за замовчуванням.
+// Копія вагона отримує власну копію деталей.
+class DetailsHandle {
+public:
+    DetailsHandle() = default;
+    DetailsHandle(const DetailsHandle& other) : details(other.details ? std::make_unique<CarriageDetails>(*other.details) : nullptr) {}
+    DetailsHandle(DetailsHandle&&) noexcept = default;
+    DetailsHandle& operator=(const DetailsHandle& other) {
+        if (this != &other) {
+            details = other.details ? std::make_unique<CarriageDetails>(*other.details) : nullptr;
+        }
+        return *this;
+    }
+    DetailsHandle& operator=(DetailsHandle&&) noexcept = default;
+
+    const CarriageDetails& get() const {
+        static const CarriageDetails defaults;
+        return details ? *details : defaults;
+    }
+
+    CarriageDetails& edit() {
+        if (!details) details = std::make_unique<CarriageDetails>();
+        return *details;
+    }
+
+private:
+    std::unique_ptr<CarriageDetails> details;
+};
+
+// Базовий клас Carriage.
+// Гарячий запис - поля, потрібні для індексу і підсумків складу; решта - у CarriageDetails.
 class Carriage {
 protected:
+    ObserverLink link;
     std::string id;
-    std::string type;
+    InternedString type;
     double weight;
     double length;
-    std::string owner;
-    std::string manufactureDate;
-    std::string maintenanceDate;
-    int maxSpeed;
-    bool inService;
-    std::string color;
-    std::string material;
-    double energyConsumption;
-    double manufacturingCost;
-    std::string lastStation;
-    int currentPassengers;
+    DetailsHandle details;
+    CarriageKind kind;
 
 public:
-    Carriage(const std::string& id, const std::string& type, double weight, double length)
-        : id(id), type(type), weight(weight), length(length) {}
+    Carriage(const std::string& id, const std::string& type, double weight, double length, CarriageKind kind = CarriageKind::Other)
+        : id(id), type(type), weight(weight), length(length), kind(kind) {}
+
+    Carriage(const Carriage&) = default;
+    Carriage(Carriage&&) = default;
 
+    // Присвоєння копіює значення, але не вид (він визначається класом) і не склад
+    Carriage& operator=(const Carriage& other) {
+        AssignGuard guard(*this, other);
+        assignFields(other);
+        return *this;
+    }
     virtual ~Carriage() {}
 
     // Геттери
-    std::string getId() const { return id; }
-    std::string getType() const { return type; }
+    const std::string& getId() const { return id; }
+    const std::string& getType() const { return type.str(); }
+    CarriageKind getKind() const { return kind; }
     double getWeight() const { return weight; }
     double getLength() const { return length; }
-    std::string getOwner() const { return owner; }
-    std::string getManufactureDate() const { return manufactureDate; }
-    std::string getMaintenanceDate() const { return maintenanceDate; }
-    int getMaxSpeed() const { return maxSpeed; }
-    bool isInService() const { return inService; }
-    std::string getColor() const { return color; }
-    std::string getMaterial() const { return material; }
-    double getEnergyConsumption() const { return energyConsumption; }
-    double getManufacturingCost() const { return manufacturingCost; }
-    std::string getLastStation() const { return lastStation; }
-    int getCurrentPassengers() const { return currentPassengers; }
+    const std::string& getOwner() const { return details.get().owner.str(); }
+    const std::string& getManufactureDate() const { return details.get().manufactureDate; }
+    const std::string& getMaintenanceDate() const { return details.get().maintenanceDate; }
+    int getMaxSpeed() const { return details.get().maxSpeed; }
+    bool isInService() const { return details.get().inService; }
+    const std::string& getColor() const { return details.get().color.str(); }
+    const std::string& getMaterial() const { return details.get().material.str(); }
+    double getEnergyConsumption() const { return details.get().energyConsumption; }
+    double getManufacturingCost() const { return details.get().manufacturingCost; }
+    const std::string& getLastStation() const { return details.get().lastStation; }
+    int getCurrentPassengers() const { return details.get().currentPassengers; }
 
     // Сеттери
-    void setId(const std::string& id) { this->id = id; }
-    void setType(const std::string& type) { this->type = type; }
-    void setWeight(double weight) { this->weight = weight; }
+    void setId(const std::string& id) {
+        if (link.observer) link.observer->beforeIdChange(*this, id);
+        this->id = id;
+    }
+    void setType(const std::string& type) {
+        std::string oldType = this->type.str();
+        this->type = InternedString(type);
+        if (link.observer) link.observer->typeChanged(*this, oldType);
+    }
+    void setWeight(double weight) {
+        double oldWeight = this->weight;
+        this->weight = weight;
+        if (link.observer) link.observer->weightChanged(*this, oldWeight);
+    }
     void setLength(double length) { this->length = length; }
-    void setOwner(const std::string& owner) { this->owner = owner; }
-    void setManufactureDate(const std::string& manufactureDate) { this->manufactureDate = manufactureDate; }
-    void setMaintenanceDate(const std::string& maintenanceDate) { this->maintenanceDate = maintenanceDate; }
-    void setMaxSpeed(int maxSpeed) { this->maxSpeed = maxSpeed; }
-    void setInService(bool inService) { this->inService = inService; }
-    void setColor(const std::string& color) { this->color = color; }
-    void setMaterial(const std::string& material) { this->material = material; }
-    void setEnergyConsumption(double energyConsumption) { this->energyConsumption = energyConsumption; }
-    void setManufacturingCost(double manufacturingCost) { this->manufacturingCost = manufacturingCost; }
-    void setLastStation(const std::string& lastStation) { this->lastStation = lastStation; }
-    void setCurrentPassengers(int currentPassengers) { this->currentPassengers = currentPassengers; }
+    void setOwner(const std::string& owner) { details.edit().owner = InternedString(owner); }
+    void setManufactureDate(const std::string& manufactureDate) { details.edit().manufactureDate = manufactureDate; }
+    void setMaintenanceDate(const std::string& maintenanceDate) { details.edit().maintenanceDate = maintenanceDate; }
+    void setMaxSpeed(int maxSpeed) { details.edit().maxSpeed = maxSpeed; }
+    void setInService(bool inService) { details.edit().inService = inService; }
+    void setColor(const std::string& color) { details.edit().color = InternedString(color); }
+    void setMaterial(const std::string& material) { details.edit().material = InternedString(material); }
+    void setEnergyConsumption(double energyConsumption) { details.edit().energyConsumption = energyConsumption; }
+    void setManufacturingCost(double manufacturingCost) { details.edit().manufacturingCost = manufacturingCost; }
+    void setLastStation(const std::string& lastStation) { details.edit().lastStation = lastStation; }
+    void setCurrentPassengers(int currentPassengers) { details.edit().currentPassengers = currentPassengers; }
+
+    // Встановлюється складом, до якого зчеплено вагон
+    void setObserver(CarriageObserver* observer) { link.observer = observer; }
 
     virtual void print() const = 0;
+
+protected:
+    // Повідомляє склад про присвоєння зчепленому вагону: до і після зміни полів
+    class AssignGuard {
+    public:
+        AssignGuard(Carriage& carriage, const Carriage& source) : carriage(carriage) {
+            if (carriage.link.observer) carriage.link.observer->beforeAssign(carriage, source);
+        }
+        ~AssignGuard() {
+            if (carriage.link.observer) carriage.link.observer->afterAssign(carriage);
+        }
+
+    private:
+        Carriage& carriage;
+    };
+
+    void assignFields(const Carriage& other) {
+        id = other.id;
+        type = other.type;
+        weight = other.weight;
+        length = other.length;
+        details = other.details;
+    }
 };
 
 // Похідні класи від Carriage
 class PassengerCarriage : public Carriage {
     int seatsCount;
-    std::string comfortLevel;
+    InternedString comfortLevel;
 
 public:
+    static constexpr CarriageKind Kind = CarriageKind::Passenger;
+
     PassengerCarriage(const std::string& id, double weight, double length, int seatsCount, const std::string& comfortLevel)
-        : Carriage(id, "Passenger", weight, length), seatsCount(seatsCount), comfortLevel(comfortLevel) {}
+        : Carriage(id, "Passenger", weight, length, Kind), seatsCount(seatsCount), comfortLevel(comfortLevel) {}
+
+    PassengerCarriage(const PassengerCarriage&) = default;
+    PassengerCarriage(PassengerCarriage&&) = default;
+    PassengerCarriage& operator=(const PassengerCarriage& other) {
+        AssignGuard guard(*this, other);
+        assignFields(other);
+        seatsCount = other.seatsCount;
+        comfortLevel = other.comfortLevel;
+        return *this;
+    }
 
     int getSeatsCount() const { return seatsCount; }
-    void setSeatsCount(int seatsCount) { this->seatsCount = seatsCount; }
+    void setSeatsCount(int seatsCount) {
+        int oldSeats = this->seatsCount;
+        this->seatsCount = seatsCount;
+        if (link.observer) link.observer->seatsChanged(*this, oldSeats);
+    }
 
-    std::string getComfortLevel() const { return comfortLevel; }
-    void setComfortLevel(const std::string& comfortLevel) { this->comfortLevel = comfortLevel; }
+    const std::string& getComfortLevel() const { return comfortLevel.str(); }
+    void setComfortLevel(const std::string& comfortLevel) { this->comfortLevel = InternedString(comfortLevel); }
 
     void print() const override {
         std::cout << "Passenger Carriage [ID: " << id << ", Weight: " << weight << ", Length: " << length 
-                  << ", Seats: " << seatsCount << ", Comfort: " << comfortLevel << "]" << std::endl;
+                  << ", Seats: " << seatsCount << ", Comfort: " << comfortLevel.str() << "]" << std::endl;
     }
 };
 
 class FreightCarriage : public Carriage {
     double maxLoadCapacity;
-    std::string cargoType;
+    InternedString cargoType;
 
 public:
+    static constexpr CarriageKind Kind = CarriageKind::Freight;
+
     FreightCarriage(const std::string& id, double weight, double length, double maxLoadCapacity, const std::string& cargoType)
-        : Carriage(id, "Freight", weight, length), maxLoadCapacity(maxLoadCapacity), cargoType(cargoType) {}
+        : Carriage(id, "Freight", weight, length, Kind), maxLoadCapacity(maxLoadCapacity), cargoType(cargoType) {}
+
+    FreightCarriage(const FreightCarriage&) = default;
+    FreightCarriage(FreightCarriage&&) = default;
+    FreightCarriage& operator=(const FreightCarriage& other) {
+        AssignGuard guard(*this, other);
+        assignFields(other);
+        maxLoadCapacity = other.maxLoadCapacity;
+        cargoType = other.cargoType;
+        return *this;
+    }
 
     double getMaxLoadCapacity() const { return maxLoadCapacity; }
-    void setMaxLoadCapacity(double maxLoadCapacity) { this->maxLoadCapacity = maxLoadCapacity; }
+    void setMaxLoadCapacity(double maxLoadCapacity) {
+        double oldCapacity = this->maxLoadCapacity;
+        this->maxLoadCapacity = maxLoadCapacity;
+        if (link.observer) link.observer->cargoCapacityChanged(*this, oldCapacity);
+    }
 
-    std::string getCargoType() const { return cargoType; }
-    void setCargoType(const std::string& cargoType) { this->cargoType = cargoType; }
+    const std::string& getCargoType() const { return cargoType.str(); }
+    void setCargoType(const std::string& cargoType) { this->cargoType = InternedString(cargoType); }
 
     void print() const override {
         std::cout << "Freight Carriage [ID: " << id << ", Weight: " << weight << ", Length: " << length 
-                  << ", Max Load: " << maxLoadCapacity << ", Cargo: " << cargoType << "]" << std::endl;
+                  << ", Max Load: " << maxLoadCapacity << ", Cargo: " << cargoType.str() << "]" << std::endl;
     }
 };
 
@@ -112,8 +350,20 @@ class DiningCarriage : public Carriage {
     bool hasKitchen;
 
 public:
+    static constexpr CarriageKind Kind = CarriageKind::Dining;
+
     DiningCarriage(const std::string& id, double weight, double length, int tablesCount, bool hasKitchen)
-        : Carriage(id, "Dining", weight, length), tablesCount(tablesCount), hasKitchen(hasKitchen) {}
+        : Carriage(id, "Dining", weight, length, Kind), tablesCount(tablesCount), hasKitchen(hasKitchen) {}
+
+    DiningCarriage(const DiningCarriage&) = default;
+    DiningCarriage(DiningCarriage&&) = default;
+    DiningCarriage& operator=(const DiningCarriage& other) {
+        AssignGuard guard(*this, other);
+        assignFields(other);
+        tablesCount = other.tablesCount;
+        hasKitchen = other.hasKitchen;
+        return *this;
+    }
 
     int getTablesCount() const { return tablesCount; }
     void setTablesCount(int tablesCount) { this->tablesCount = tablesCount; }
@@ -132,8 +382,20 @@ class SleepingCarriage : public Carriage {
     bool hasShowers;
 
 public:
+    static constexpr CarriageKind Kind = CarriageKind::Sleeping;
+
     SleepingCarriage(const std::string& id, double weight, double length, int compartmentsCount, bool hasShowers)
-        : Carriage(id, "Sleeping", weight, length), compartmentsCount(compartmentsCount), hasShowers(hasShowers) {}
+        : Carriage(id, "Sleeping", weight, length, Kind), compartmentsCount(compartmentsCount), hasShowers(hasShowers) {}
+
+    SleepingCarriage(const SleepingCarriage&) = default;
+    SleepingCarriage(SleepingCarriage&&) = default;
+    SleepingCarriage& operator=(const SleepingCarriage& other) {
+        AssignGuard guard(*this, other);
+        assignFields(other);
+        compartmentsCount = other.compartmentsCount;
+        hasShowers = other.hasShowers;
+        return *this;
+    }
 
     int getCompartmentsCount() const { return compartmentsCount; }
     void setCompartmentsCount(int compartmentsCount) { this->compartmentsCount = compartmentsCount; }
@@ -147,90 +409,630 @@ public:
     }
 };
 
+// Підсумки набору вагонів (складу або парку), що підтримуються інкрементно
+struct CarriageTotals {
+    double weight = 0;
+    long long passengerCapacity = 0;
+    size_t carriages = 0;
+    std::array<size_t, 5> kinds{};
+    std::unordered_map<std::string, size_t> types;
+
+    void add(const Carriage& carriage, int sign) {
+        weight += sign * carriage.getWeight();
+        carriages += sign;
+        kinds[static_cast<size_t>(carriage.getKind())] += sign;
+        countType(carriage.getType(), sign);
+        if (carriage.getKind() == CarriageKind::Passenger) {
+            passengerCapacity += sign * static_cast<const PassengerCarriage&>(carriage).getSeatsCount();
+        }
+    }
+
+    void add(const CarriageTotals& other, int sign) {
+        weight += sign * other.weight;
+        passengerCapacity += sign * other.passengerCapacity;
+        carriages += sign * other.carriages;
+        for (size_t i = 0; i < kinds.size(); ++i) {
+            kinds[i] += sign * other.kinds[i];
+        }
+        for (const auto& entry : other.types) {
+            countType(entry.first, sign * static_cast<long long>(entry.second));
+        }
+    }
+
+    void countType(const std::string& type, long long delta) {
+        size_t& count = types[type];
+        count += delta;
+        if (count == 0) {
+            types.erase(type);
+        }
+    }
+
+    size_t count(const std::string& type) const {
+        auto found = types.find(type);
+        return found != types.end() ? found->second : 0;
+    }
+};
+
+class Fleet;
+
 // Клас Train
-class Train {
-    std::list<std::unique_ptr<Carriage>> carriages;
+// Вагони зберігаються за видами в суцільних пулах (std::vector значень), тож агрегати - це лінійний
+// прохід по щільних масивах без розіменування вказівників. Порядок зчеплення зберігає окремий
+// вектор слотів (пул, індекс у пулі); видалений вагон лишає в ньому позначку, яку прибирає ущільнення.
+// Вагони інших похідних класів зберігаються в окремому пулі через unique_ptr.
+// Вказівники, повернені findCarriage і maxCargoCapacityCarriage, дійсні до наступної зміни складу.
+class Train : private CarriageObserver {
+    struct Slot {
+        CarriageKind pool;
+        bool removed;
+        std::uint32_t index;
+    };
+
+    // Запис вантажопідйомності: (ємність, позиція в порядку зчеплення); найбільша ємність - першою,
+    // за рівної - ближчий до голови потяга
+    struct CargoEntry {
+        double capacity;
+        std::uint32_t position;
+
+        bool operator<(const CargoEntry& other) const {
+            return capacity != other.capacity ? capacity > other.capacity : position < other.position;
+        }
+    };
+
+    // Пул вагонів одного типу; positions[i] - позиція вагона items[i] у порядку зчеплення
+    template <typename T>
+    struct Pool {
+        std::vector<T> items;
+        std::vector<std::uint32_t> positions;
+    };
+
+    Pool<PassengerCarriage> passengers;
+    Pool<FreightCarriage> freight;
+    Pool<DiningCarriage> dining;
+    Pool<SleepingCarriage> sleeping;
+    Pool<std::unique_ptr<Carriage>> others;
+    std::vector<Slot> order;
+    size_t removedCount = 0;
+    std::unordered_map<std::string, std::uint32_t> index;
     std::string name;
     std::string routeNumber;
 
+    // Підсумки складу оновлюються при зчепленні, відчепленні та через сеттери вагонів (CarriageObserver)
+    CarriageTotals totals;
+    std::set<CargoEntry> cargo;
+
+    // Парк, до якого належить склад (див. Fleet)
+    Fleet* fleet = nullptr;
+    std::uint64_t fleetSequence = 0;
+    double publishedCargo = 0;
+
+    friend class Fleet;
+
 public:
     Train(const std::string& name, const std::string& routeNumber)
         : name(name), routeNumber(routeNumber) {}
 
+    // Вагони тримають вказівник на склад, тож склад не копіюється і не переміщується
+    Train(const Train&) = delete;
+    Train& operator=(const Train&) = delete;
+
+    const std::string& getName() const { return name; }
+    const std::string& getRouteNumber() const { return routeNumber; }
+
+    // ID вагона в складі має бути унікальним. Пул обирається за точним типом (typeid) один раз при додаванні;
+    // похідні від стандартних класів вагони потрапляють у загальний пул, але зберігають свій вид.
     void addCarriage(std::unique_ptr<Carriage> carriage) {
-        carriages.push_back(std::move(carriage));
+        if (index.count(carriage->getId())) {
+            throw std::invalid_argument("Duplicate carriage ID: " + carriage->getId());
+        }
+        std::uint32_t position = static_cast<std::uint32_t>(order.size());
+        index.emplace(carriage->getId(), position);
+        const std::type_info& type = typeid(*carriage);
+        if (type == typeid(PassengerCarriage)) {
+            append(passengers, std::move(static_cast<PassengerCarriage&>(*carriage)));
+        } else if (type == typeid(FreightCarriage)) {
+            append(freight, std::move(static_cast<FreightCarriage&>(*carriage)));
+        } else if (type == typeid(DiningCarriage)) {
+            append(dining, std::move(static_cast<DiningCarriage&>(*carriage)));
+        } else if (type == typeid(SleepingCarriage)) {
+            append(sleeping, std::move(static_cast<SleepingCarriage&>(*carriage)));
+        } else {
+            append(others, std::move(carriage));
+        }
+
+        Carriage& added = carriageAt(order.back());
+        added.setObserver(this);
+        applyTotals(added, 1);
+        if (added.getKind() == CarriageKind::Freight) {
+            cargo.insert({static_cast<const FreightCarriage&>(added).getMaxLoadCapacity(), position});
+            publishCargoMax();
+        }
     }
 
     void removeCarriage(const std::string& id) {
-        carriages.remove_if([&id](const std::unique_ptr<Carriage>& carriage) { return carriage->getId() == id; });
+        auto found = index.find(id);
+        if (found == index.end()) {
+            return;
+        }
+        Slot& slot = order[found->second];
+        const Carriage& removed = carriageAt(slot);
+        applyTotals(removed, -1);
+        bool freightRemoved = removed.getKind() == CarriageKind::Freight;
+        if (freightRemoved) {
+            cargo.erase({static_cast<const FreightCarriage&>(removed).getMaxLoadCapacity(), found->second});
+        }
+        switch (slot.pool) {
+            case CarriageKind::Passenger: erase(passengers, slot.index); break;
+            case CarriageKind::Freight: erase(freight, slot.index); break;
+            case CarriageKind::Dining: erase(dining, slot.index); break;
+            case CarriageKind::Sleeping: erase(sleeping, slot.index); break;
+            case CarriageKind::Other: erase(others, slot.index); break;
+        }
+        slot.removed = true;
+        index.erase(found);
+        if (++removedCount > order.size() / 2) {
+            compact();
+        }
+        if (freightRemoved) {
+            publishCargoMax();
+        }
     }
 
     Carriage* findCarriage(const std::string& id) {
-        for (const auto& carriage : carriages) {
-            if (carriage->getId() == id) {
-                return carriage.get();
-            }
+        auto found = index.find(id);
+        return found != index.end() ? &carriageAt(order[found->second]) : nullptr;
+    }
+
+    // Зміна ID вагона в складі (те саме, що setId на вагоні, але без винятку для зайнятого ID)
+    bool renameCarriage(const std::string& id, const std::string& newId) {
+        Carriage* carriage = findCarriage(id);
+        if (!carriage || (id != newId && index.count(newId))) {
+            return false;
         }
-        return nullptr;
+        carriage->setId(newId);
+        return true;
     }
 
     void printCarriages() const {
-        for (const auto& carriage : carriages) {
-            carriage->print();
+        for (const Slot& slot : order) {
+            if (!slot.removed) {
+                carriageAt(slot).print();
+            }
         }
     }
 
-    int totalPassengerCapacity() const {
-        int total = 0;
-        for (const auto& carriage : carriages) {
-            if (auto p = dynamic_cast<PassengerCarriage*>(carriage.get())) {
-                total += p->getSeatsCount();
+    // Обхід вагонів одного виду (T - PassengerCarriage, FreightCarriage, DiningCarriage або SleepingCarriage)
+    // без RTTI і порівняння рядків: спершу щільний пул, потім похідні вагони цього виду із загального пулу
+    template <typename T, typename F>
+    void forEach(F f) const {
+        forEachIndexed<T>([&](const T& carriage, std::uint32_t) { f(carriage); });
+    }
+
+    // Статичний відвідувач для гарячих агрегатів: для кожного пулу викликається перевантаження
+    // visitor(const PassengerCarriage&) тощо, вибране під час компіляції, без віртуальних викликів;
+    // вагони виду Other передаються як const Carriage&
+    template <typename Visitor>
+    void visit(Visitor&& visitor) const {
+        for (const auto& carriage : passengers.items) visitor(carriage);
+        for (const auto& carriage : freight.items) visitor(carriage);
+        for (const auto& carriage : dining.items) visitor(carriage);
+        for (const auto& carriage : sleeping.items) visitor(carriage);
+        for (const auto& carriage : others.items) {
+            switch (carriage->getKind()) {
+                case CarriageKind::Passenger: visitor(static_cast<const PassengerCarriage&>(*carriage)); break;
+                case CarriageKind::Freight: visitor(static_cast<const FreightCarriage&>(*carriage)); break;
+                case CarriageKind::Dining: visitor(static_cast<const DiningCarriage&>(*carriage)); break;
+                case CarriageKind::Sleeping: visitor(static_cast<const SleepingCarriage&>(*carriage)); break;
+                case CarriageKind::Other: visitor(static_cast<const Carriage&>(*carriage)); break;
             }
         }
-        return total;
     }
 
+    // Агрегати читаються з підтримуваних підсумків за O(1)
+    int totalPassengerCapacity() const {
+        return static_cast<int>(totals.passengerCapacity);
+    }
+
+    // Перший у порядку зчеплення вагон з найбільшою (додатною) вантажопідйомністю
     Carriage* maxCargoCapacityCarriage() const {
-        Carriage* maxCarriage = nullptr;
-        double maxCapacity = 0;
-        for (const auto& carriage : carriages) {
-            if (auto f = dynamic_cast<FreightCarriage*>(carriage.get())) {
-                if (f->getMaxLoadCapacity() > maxCapacity) {
-                    maxCapacity = f->getMaxLoadCapacity();
-                    maxCarriage = f;
-                }
-            }
+        if (cargo.empty() || !(cargo.begin()->capacity > 0)) {
+            return nullptr;
         }
-        return maxCarriage;
+        return const_cast<Carriage*>(&carriageAt(order[cargo.begin()->position]));
     }
 
+    int countCarriagesByType(CarriageKind kind) const {
+        return static_cast<int>(totals.kinds[static_cast<size_t>(kind)]);
+    }
+
+    // За рядком типу (його можна змінити через setType)
     int countCarriagesByType(const std::string& type) const {
-        return std::count_if(carriages.begin(), carriages.end(), [&type](const std::unique_ptr<Carriage>& carriage) {
-            return carriage->getType() == type;
-        });
+        return static_cast<int>(totals.count(type));
     }
 
     double totalTrainWeight() const {
-        double totalWeight = 0;
-        for (const auto& carriage : carriages) {
-            totalWeight += carriage->getWeight();
-        }
-        return totalWeight;
+        return totals.weight;
     }
 
     void changeRoute(const std::string& newRouteNumber) {
         routeNumber = newRouteNumber;
     }
 
+    // Вагони "Special" не мають власного класу, тож рахуються за рядком типу
     bool hasSpecialCarriages() const {
-        return std::any_of(carriages.begin(), carriages.end(), [](const std::unique_ptr<Carriage>& carriage) {
-            return carriage->getType() == "Special";
+        return totals.count("Special") > 0;
+    }
+
+private:
+    // CarriageObserver: зміни вагонів, зчеплених у цей склад
+    void beforeIdChange(const Carriage& carriage, const std::string& newId) override {
+        if (newId == carriage.getId()) {
+            return;
+        }
+        if (index.count(newId)) {
+            throw std::invalid_argument("Duplicate carriage ID: " + newId);
+        }
+        auto found = index.find(carriage.getId());
+        std::uint32_t position = found->second;
+        index.erase(found);
+        index.emplace(newId, position);
+    }
+
+    void typeChanged(const Carriage& carriage, const std::string& oldType) override {
+        totals.countType(oldType, -1);
+        totals.countType(carriage.getType(), 1);
+        if (fleetTotals()) {
+            fleetTotals()->countType(oldType, -1);
+            fleetTotals()->countType(carriage.getType(), 1);
+        }
+    }
+
+    void weightChanged(const Carriage& carriage, double oldWeight) override {
+        totals.weight += carriage.getWeight() - oldWeight;
+        if (fleetTotals()) {
+            fleetTotals()->weight += carriage.getWeight() - oldWeight;
+        }
+    }
+
+    void seatsChanged(const Carriage& carriage, int oldSeats) override {
+        if (carriage.getKind() != CarriageKind::Passenger) {
+            return;
+        }
+        int delta = static_cast<const PassengerCarriage&>(carriage).getSeatsCount() - oldSeats;
+        totals.passengerCapacity += delta;
+        if (fleetTotals()) {
+            fleetTotals()->passengerCapacity += delta;
+        }
+    }
+
+    void cargoCapacityChanged(const Carriage& carriage, double oldCapacity) override {
+        if (carriage.getKind() != CarriageKind::Freight) {
+            return;
+        }
+        std::uint32_t position = index.at(carriage.getId());
+        cargo.erase({oldCapacity, position});
+        cargo.insert({static_cast<const FreightCarriage&>(carriage).getMaxLoadCapacity(), position});
+        publishCargoMax();
+    }
+
+    void beforeAssign(const Carriage& carriage, const Carriage& source) override {
+        beforeIdChange(carriage, source.getId());
+        applyTotals(carriage, -1);
+        if (carriage.getKind() == CarriageKind::Freight) {
+            cargo.erase({static_cast<const FreightCarriage&>(carriage).getMaxLoadCapacity(), index.at(source.getId())});
+        }
+    }
+
+    void afterAssign(const Carriage& carriage) override {
+        applyTotals(carriage, 1);
+        if (carriage.getKind() == CarriageKind::Freight) {
+            cargo.insert({static_cast<const FreightCarriage&>(carriage).getMaxLoadCapacity(), index.at(carriage.getId())});
+            publishCargoMax();
+        }
+    }
+
+    void applyTotals(const Carriage& carriage, int sign) {
+        totals.add(carriage, sign);
+        if (fleetTotals()) {
+            fleetTotals()->add(carriage, sign);
+        }
+    }
+
+    CarriageTotals* fleetTotals();
+    void publishCargoMax();
+
+    template <typename T>
+    void append(Pool<T>& pool, T&& carriage) {
+        order.push_back({poolKind(pool), false, static_cast<std::uint32_t>(pool.items.size())});
+        pool.items.push_back(std::move(carriage));
+        pool.positions.push_back(static_cast<std::uint32_t>(order.size() - 1));
+    }
+
+    // Видалення з пулу переносом останнього елемента на місце видаленого.
+    // Переноситься конструюванням, а не присвоєнням: присвоєння вагона повідомляє склад.
+    template <typename T>
+    void erase(Pool<T>& pool, std::uint32_t i) {
+        static_assert(std::is_nothrow_move_constructible<T>::value, "pool items must be nothrow movable");
+        size_t last = pool.items.size() - 1;
+        if (i != last) {
+            std::destroy_at(&pool.items[i]);
+            new (&pool.items[i]) T(std::move(pool.items[last]));
+            pool.positions[i] = pool.positions[last];
+            order[pool.positions[i]].index = i;
+        }
+        pool.items.pop_back();
+        pool.positions.pop_back();
+    }
+
+    // Ущільнення порядку зчеплення: прибирає позначки видалених вагонів
+    void compact() {
+        std::vector<Slot> live;
+        live.reserve(order.size() - removedCount);
+        for (const Slot& slot : order) {
+            if (slot.removed) {
+                continue;
+            }
+            std::uint32_t position = static_cast<std::uint32_t>(live.size());
+            live.push_back(slot);
+            switch (slot.pool) {
+                case CarriageKind::Passenger: passengers.positions[slot.index] = position; break;
+                case CarriageKind::Freight: freight.positions[slot.index] = position; break;
+                case CarriageKind::Dining: dining.positions[slot.index] = position; break;
+                case CarriageKind::Sleeping: sleeping.positions[slot.index] = position; break;
+                case CarriageKind::Other: others.positions[slot.index] = position; break;
+            }
+            index[carriageAt(slot).getId()] = position;
+        }
+        order.swap(live);
+        removedCount = 0;
+
+        cargo.clear();
+        forEachIndexed<FreightCarriage>([&](const FreightCarriage& carriage, std::uint32_t position) {
+            cargo.insert({carriage.getMaxLoadCapacity(), position});
         });
     }
+
+    template <typename T>
+    static CarriageKind poolKind(const Pool<T>&) { return T::Kind; }
+    static CarriageKind poolKind(const Pool<std::unique_ptr<Carriage>>&) { return CarriageKind::Other; }
+
+    const Pool<PassengerCarriage>& pool(const PassengerCarriage*) const { return passengers; }
+    const Pool<FreightCarriage>& pool(const FreightCarriage*) const { return freight; }
+    const Pool<DiningCarriage>& pool(const DiningCarriage*) const { return dining; }
+    const Pool<SleepingCarriage>& pool(const SleepingCarriage*) const { return sleeping; }
+
+    // Обхід вагонів виду T разом з їхніми позиціями в порядку зчеплення
+    template <typename T, typename F>
+    void forEachIndexed(F f) const {
+        const Pool<T>& dense = pool(static_cast<const T*>(nullptr));
+        for (size_t i = 0; i < dense.items.size(); ++i) {
+            f(dense.items[i], dense.positions[i]);
+        }
+        for (size_t i = 0; i < others.items.size(); ++i) {
+            if (others.items[i]->getKind() == T::Kind) {
+                f(static_cast<const T&>(*others.items[i]), others.positions[i]);
+            }
+        }
+    }
+
+    Carriage& carriageAt(const Slot& slot) {
+        return const_cast<Carriage&>(static_cast<const Train&>(*this).carriageAt(slot));
+    }
+
+    const Carriage& carriageAt(const Slot& slot) const {
+        switch (slot.pool) {
+            case CarriageKind::Passenger: return passengers.items[slot.index];
+            case CarriageKind::Freight: return freight.items[slot.index];
+            case CarriageKind::Dining: return dining.items[slot.index];
+            case CarriageKind::Sleeping: return sleeping.items[slot.index];
+            default: return *others.items[slot.index];
+        }
+    }
+};
+
+// Fleet: реєстр складів з підсумками по всьому парку. Склади повідомляють парк про кожну зміну,
+// тож загальні суми і лічильники читаються за O(1), а вагон з найбільшою вантажопідйомністю -
+// з упорядкованої множини максимумів складів (оновлення O(log кількості складів)).
+class Fleet {
+public:
+    Fleet() = default;
+
+    // Склади тримають вказівник на парк, тож парк не копіюється і не переміщується
+    Fleet(const Fleet&) = delete;
+    Fleet& operator=(const Fleet&) = delete;
+
+    Train& addTrain(const std::string& name, const std::string& routeNumber) {
+        return addTrain(std::make_unique<Train>(name, routeNumber));
+    }
+
+    // Назва складу в парку має бути унікальною; склад може вже мати вагони
+    Train& addTrain(std::unique_ptr<Train> train) {
+        if (train->fleet || trains.count(train->getName())) {
+            throw std::invalid_argument("Train is already registered: " + train->getName());
+        }
+        Train& added = *train;
+        added.fleet = this;
+        added.fleetSequence = nextSequence++;
+        added.publishedCargo = 0;
+        totals.add(added.totals, 1);
+        trains.emplace(added.getName(), std::move(train));
+        added.publishCargoMax();
+        return added;
+    }
+
+    bool removeTrain(const std::string& name) {
+        auto found = trains.find(name);
+        if (found == trains.end()) {
+            return false;
+        }
+        Train& train = *found->second;
+        totals.add(train.totals, -1);
+        updateCargoMax(train, 0);
+        trains.erase(found);
+        return true;
+    }
+
+    Train* findTrain(const std::string& name) {
+        auto found = trains.find(name);
+        return found != trains.end() ? found->second.get() : nullptr;
+    }
+
+    size_t trainCount() const { return trains.size(); }
+    size_t carriageCount() const { return totals.carriages; }
+    double totalWeight() const { return totals.weight; }
+    long long totalPassengerCapacity() const { return totals.passengerCapacity; }
+    size_t countCarriagesByType(CarriageKind kind) const { return totals.kinds[static_cast<size_t>(kind)]; }
+    size_t countCarriagesByType(const std::string& type) const { return totals.count(type); }
+    bool hasSpecialCarriages() const { return totals.count("Special") > 0; }
+
+    // Вагон з найбільшою вантажопідйомністю в парку; за рівної - зі складу, доданого раніше
+    Carriage* maxCargoCapacityCarriage() const {
+        return cargo.empty() ? nullptr : cargo.begin()->train->maxCargoCapacityCarriage();
+    }
+
+private:
+    struct CargoEntry {
+        double capacity;
+        std::uint64_t sequence;
+        Train* train;
+
+        bool operator<(const CargoEntry& other) const {
+            return capacity != other.capacity ? capacity > other.capacity : sequence < other.sequence;
+        }
+    };
+
+    std::unordered_map<std::string, std::unique_ptr<Train>> trains;
+    CarriageTotals totals;
+    std::set<CargoEntry> cargo;
+    std::uint64_t nextSequence = 0;
+
+    // Склад публікує в парк лише свій максимум вантажопідйомності (0 - немає вантажних вагонів)
+    void updateCargoMax(Train& train, double capacity) {
+        if (capacity == train.publishedCargo) {
+            return;
+        }
+        if (train.publishedCargo > 0) {
+            cargo.erase({train.publishedCargo, train.fleetSequence, &train});
+        }
+        if (capacity > 0) {
+            cargo.insert({capacity, train.fleetSequence, &train});
+        }
+        train.publishedCargo = capacity;
+    }
+
+    friend class Train;
 };
 
+inline CarriageTotals* Train::fleetTotals() {
+    return fleet ? &fleet->totals : nullptr;
+}
+
+inline void Train::publishCargoMax() {
+    if (fleet) {
+        fleet->updateCargoMax(*this, cargo.empty() ? 0 : std::max(cargo.begin()->capacity, 0.0));
+    }
+}
+
+// Бенчмарк агрегатів: попередній підхід (список unique_ptr, dynamic_cast, копії рядка типу) проти Train
+void runAggregationBenchmark(size_t count) {
+    auto make = [](size_t i) -> std::unique_ptr<Carriage> {
+        std::string id = std::to_string(i);
+        double weight = 20.0 + static_cast<double>(i % 17);
+        switch (i % 4) {
+            case 0: return std::make_unique<PassengerCarriage>(id, weight, 10.0, 40 + static_cast<int>(i % 60), "Economy");
+            case 1: return std::make_unique<FreightCarriage>(id, weight, 15.0, static_cast<double>(i % 1000), "Coal");
+            case 2: return std::make_unique<DiningCarriage>(id, weight, 12.0, 10, true);
+            default: return std::make_unique<SleepingCarriage>(id, weight, 14.0, 20, true);
+        }
+    };
+
+    std::list<std::unique_ptr<Carriage>> legacy;
+    Train train("Bench", "0");
+    for (size_t i = 0; i < count; ++i) {
+        legacy.push_back(make(i));
+        train.addCarriage(make(i));
+    }
+
+    // Найкращий час з п'яти запусків
+    auto measure = [](const char* name, auto&& run) {
+        double best = 0;
+        double result = 0;
+        for (int attempt = 0; attempt < 5; ++attempt) {
+            auto start = std::chrono::steady_clock::now();
+            result = run();
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            best = attempt == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        std::cout << name << ": " << best << " ms (result " << result << ")" << std::endl;
+    };
+
+    std::cout << count << " carriages" << std::endl;
+    std::cout << "Object size: Passenger " << sizeof(PassengerCarriage) << " B, Freight " << sizeof(FreightCarriage)
+              << " B, Dining " << sizeof(DiningCarriage) << " B, Sleeping " << sizeof(SleepingCarriage)
+              << " B, details " << sizeof(CarriageDetails) << " B (only when set), interned strings "
+              << StringPool::global().size() << std::endl;
+    measure("Passenger capacity, dynamic_cast", [&]() {
+        int total = 0;
+        for (const auto& carriage : legacy) {
+            if (auto p = dynamic_cast<PassengerCarriage*>(carriage.get())) {
+                total += p->getSeatsCount();
+            }
+        }
+        return static_cast<double>(total);
+    });
+    measure("Passenger capacity, visitor", [&]() {
+        int total = 0;
+        train.visit(Overloaded{
+            [&](const PassengerCarriage& carriage) { total += carriage.getSeatsCount(); },
+            [](const Carriage&) {},
+        });
+        return static_cast<double>(total);
+    });
+    measure("Passenger capacity, Train", [&]() { return static_cast<double>(train.totalPassengerCapacity()); });
+    measure("Max cargo capacity, dynamic_cast", [&]() {
+        double maxCapacity = 0;
+        for (const auto& carriage : legacy) {
+            if (auto f = dynamic_cast<FreightCarriage*>(carriage.get())) {
+                maxCapacity = std::max(maxCapacity, f->getMaxLoadCapacity());
+            }
+        }
+        return maxCapacity;
+    });
+    measure("Max cargo capacity, Train", [&]() {
+        Carriage* carriage = train.maxCargoCapacityCarriage();
+        return carriage ? static_cast<FreightCarriage*>(carriage)->getMaxLoadCapacity() : 0.0;
+    });
+    measure("Count by type, string copies", [&]() {
+        int count = 0;
+        for (const auto& carriage : legacy) {
+            std::string type = carriage->getType();
+            count += type == "Passenger";
+        }
+        return static_cast<double>(count);
+    });
+    measure("Count by kind, Train", [&]() { return static_cast<double>(train.countCarriagesByType(CarriageKind::Passenger)); });
+    measure("Total weight, list", [&]() {
+        double total = 0;
+        for (const auto& carriage : legacy) {
+            total += carriage->getWeight();
+        }
+        return total;
+    });
+    measure("Total weight, visitor", [&]() {
+        double total = 0;
+        train.visit([&](const Carriage& carriage) { total += carriage.getWeight(); });
+        return total;
+    });
+    measure("Total weight, Train", [&]() { return train.totalTrainWeight(); });
+}
+
 // Приклад використання
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        runAggregationBenchmark(argc > 2 ? std::stoul(argv[2]) : 1000000);
+        return 0;
+    }
+
     Train train("Express", "12345");
 
     train.addCarriage(std::make_unique<PassengerCarriage>("1", 20.0, 10.0, 100, "Economy"));
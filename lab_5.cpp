@@ -1,15 +1,64 @@
 #include <iostream>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
+// Спільна таблиця шляхів: кожен шлях зберігається один раз, компанії тримають лише його номер
+class PathTable {
+    mutable std::shared_mutex mutex;
+    std::deque<std::string> paths;
+    std::unordered_map<std::string_view, std::uint32_t> ids;
+
+public:
+    static PathTable& global() {
+        static PathTable table;
+        return table;
+    }
+
+    std::uint32_t intern(std::string_view path) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = ids.find(path);
+            if (it != ids.end()) {
+                return it->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(path);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        std::uint32_t id = static_cast<std::uint32_t>(paths.size());
+        paths.emplace_back(path);
+        ids.emplace(paths.back(), id);
+        return id;
+    }
+
+    const std::string& path(std::uint32_t id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return paths[id];
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return paths.size();
+    }
+};
+
 class Company {
     std::string officialName;
     std::vector<std::string> synonyms;
     int mentions;
-    std::vector<std::string> filesMentioned;
+    // Номери шляхів у PathTable::global(); повтор означає, що у файлі знайдено кілька синонімів
+    std::vector<std::uint32_t> fileIds;
 
 public:
     Company(const std::string& name, const std::vector<std::string>& syns)
@@ -24,35 +73,237 @@ public:
     }
 
     void addMention(const std::string& filename) {
+        addMention(PathTable::global().intern(filename));
+    }
+
+    void addMention(std::uint32_t fileId) {
         mentions++;
-        filesMentioned.push_back(filename);
+        fileIds.push_back(fileId);
     }
 
     int getMentions() const {
         return mentions;
     }
 
+    const std::vector<std::uint32_t>& getFileIds() const {
+        return fileIds;
+    }
+
+    std::vector<std::string> getFilesMentioned() const {
+        std::vector<std::string> files;
+        files.reserve(fileIds.size());
+        for (std::uint32_t id : fileIds) {
+            files.push_back(PathTable::global().path(id));
+        }
+        return files;
+    }
+
     json toJson() const {
         json j;
         j["official_name"] = officialName;
         j["synonyms"] = synonyms;
         j["mentions"] = mentions;
-        j["files_mentioned"] = filesMentioned;
+        j["files_mentioned"] = getFilesMentioned();
         return j;
     }
 };
 
 #include <algorithm>
+#include <cctype>
 #include <sstream>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <fstream>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Нормалізація тексту за один прохід: нижній регістр + видалення пунктуації.
+// ASCII-блоки обробляються SSE2/AVX2 (вибір під час виконання), блоки з байтами >= 0x80
+// і хвости йдуть через скалярний шлях з ::tolower/::ispunct, як і раніше.
+// Вихід ніколи не довший за вхід, тому in == out допустимо.
+class TextNormalizer {
+public:
+    static size_t normalize(const char* in, size_t size, char* out) {
+#if defined(__x86_64__) || defined(__i386__)
+        static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+        if (hasAvx2) {
+            return normalizeAvx2(in, size, out);
+        }
+#endif
+#if defined(__SSE2__)
+        return normalizeSse2(in, size, out);
+#else
+        return normalizeScalar(in, size, out);
+#endif
+    }
+
+    static size_t normalizeScalar(const char* in, size_t size, char* out) {
+        size_t written = 0;
+        for (size_t i = 0; i < size; ++i) {
+            unsigned char byte = static_cast<unsigned char>(in[i]);
+            if (!std::ispunct(byte)) {
+                out[written++] = static_cast<char>(std::tolower(byte));
+            }
+        }
+        return written;
+    }
+
+#if defined(__SSE2__)
+    static size_t normalizeSse2(const char* in, size_t size, char* out) {
+        size_t i = 0;
+        size_t written = 0;
+        for (; i + 16 <= size; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            if (_mm_movemask_epi8(v) != 0) {
+                written += normalizeScalar(in + i, 16, out + written);
+                continue;
+            }
+            __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+            __m128i lowered = _mm_add_epi8(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+            __m128i punct = _mm_or_si128(
+                _mm_or_si128(inRange128(v, 0x20, 0x30), inRange128(v, 0x39, 0x41)),
+                _mm_or_si128(inRange128(v, 0x5A, 0x61), inRange128(v, 0x7A, 0x7F)));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(punct));
+            if (mask == 0) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + written), lowered);
+                written += 16;
+            } else {
+                alignas(16) char block[16];
+                _mm_store_si128(reinterpret_cast<__m128i*>(block), lowered);
+                written += compact(block, 16, mask, out + written);
+            }
+        }
+        return written + normalizeScalar(in + i, size - i, out + written);
+    }
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2")))
+    static size_t normalizeAvx2(const char* in, size_t size, char* out) {
+        size_t i = 0;
+        size_t written = 0;
+        for (; i + 32 <= size; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            if (_mm256_movemask_epi8(v) != 0) {
+                written += normalizeScalar(in + i, 32, out + written);
+                continue;
+            }
+            __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+            __m256i lowered = _mm256_add_epi8(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+            __m256i punct = _mm256_or_si256(
+                _mm256_or_si256(inRange256(v, 0x20, 0x30), inRange256(v, 0x39, 0x41)),
+                _mm256_or_si256(inRange256(v, 0x5A, 0x61), inRange256(v, 0x7A, 0x7F)));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(punct));
+            if (mask == 0) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + written), lowered);
+                written += 32;
+            } else {
+                alignas(32) char block[32];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(block), lowered);
+                written += compact(block, 32, mask, out + written);
+            }
+        }
+        return written + normalizeScalar(in + i, size - i, out + written);
+    }
+#endif
+
+private:
+    // Копіює байти блоку, для яких біт маски пунктуації не встановлено
+    static size_t compact(const char* block, size_t size, unsigned punctMask, char* out) {
+        size_t written = 0;
+        for (size_t j = 0; j < size; ++j) {
+            if (!((punctMask >> j) & 1u)) {
+                out[written++] = block[j];
+            }
+        }
+        return written;
+    }
+
+#if defined(__SSE2__)
+    // Байти у відкритому інтервалі (low, high); вхід гарантовано ASCII, тож знакове порівняння коректне
+    static __m128i inRange128(__m128i v, char low, char high) {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(low)), _mm_cmplt_epi8(v, _mm_set1_epi8(high)));
+    }
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2")))
+    static __m256i inRange256(__m256i v, char low, char high) {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(low)), _mm256_cmpgt_epi8(_mm256_set1_epi8(high), v));
+    }
+#endif
+};
+
+// FNV-1a 64 над вмістом файлу; використовується кешем для перевірки, чи змінився файл
+class ContentHash {
+    std::uint64_t state;
+
+public:
+    ContentHash() : state(14695981039346656037ull) {}
+
+    void update(std::string_view data) {
+        for (char c : data) {
+            state ^= static_cast<unsigned char>(c);
+            state *= 1099511628211ull;
+        }
+    }
+
+    std::uint64_t value() const {
+        return state;
+    }
+};
+
+// Стан токенізатора між блоками: слово, розірване межею блоку, доклеюється з наступного.
+// Слова, довші за maxTokenLength, не зберігаються (вони не можуть збігтися з жодним синонімом).
+class TokenStream {
+    static constexpr size_t windowSize = 64 * 1024;
+
+    std::string token;
+    std::vector<char> window;
+    size_t maxTokenLength;
+    bool overflow;
+
+public:
+    explicit TokenStream(size_t maxTokenLength = std::string::npos)
+        : maxTokenLength(maxTokenLength), overflow(false) {}
+
+    template <typename Callback>
+    void feed(std::string_view chunk, Callback&& onToken) {
+        window.resize(std::min(chunk.size(), windowSize));
+        for (size_t offset = 0; offset < chunk.size(); offset += windowSize) {
+            size_t length = std::min(windowSize, chunk.size() - offset);
+            size_t normalized = TextNormalizer::normalize(chunk.data() + offset, length, window.data());
+            for (size_t i = 0; i < normalized; ++i) {
+                char c = window[i];
+                if (std::isspace(static_cast<unsigned char>(c))) {
+                    finish(onToken);
+                } else if (token.size() < maxTokenLength) {
+                    token.push_back(c);
+                } else {
+                    overflow = true;
+                }
+            }
+        }
+    }
+
+    template <typename Callback>
+    void finish(Callback&& onToken) {
+        if (!token.empty() && !overflow) {
+            onToken(token);
+        }
+        token.clear();
+        overflow = false;
+    }
+};
 
 class TextAnalyzer {
 public:
     static std::string preprocessText(const std::string& text) {
         std::string processedText = text;
-        std::transform(processedText.begin(), processedText.end(), processedText.begin(), ::tolower);
-        processedText.erase(std::remove_if(processedText.begin(), processedText.end(), ::ispunct), processedText.end());
+        processedText.resize(TextNormalizer::normalize(processedText.data(), processedText.size(), processedText.data()));
         return processedText;
     }
 
@@ -67,6 +318,110 @@ public:
         }
         return count;
     }
+
+    // Токенізація з нормалізацією на льоту: регістр і пунктуація обробляються без копії всього тексту
+    template <typename Callback>
+    static void forEachToken(std::string_view text, Callback&& onToken, size_t maxTokenLength = std::string::npos) {
+        TokenStream stream(maxTokenLength);
+        stream.feed(text, onToken);
+        stream.finish(onToken);
+    }
+
+    // Потокове читання файлу блоками фіксованого розміру; пам'ять обмежена chunkSize і maxTokenLength
+    template <typename Callback>
+    static void forEachTokenInFile(const std::string& filePath, size_t chunkSize, Callback&& onToken, size_t maxTokenLength = std::string::npos, ContentHash* hash = nullptr) {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file " + filePath);
+        }
+
+        std::vector<char> chunk(std::max<size_t>(chunkSize, 1));
+        TokenStream stream(maxTokenLength);
+        while (file) {
+            file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            std::streamsize got = file.gcount();
+            if (got <= 0) {
+                break;
+            }
+            std::string_view data(chunk.data(), static_cast<size_t>(got));
+            if (hash) {
+                hash->update(data);
+            }
+            stream.feed(data, onToken);
+        }
+        if (file.bad()) {
+            throw std::runtime_error("Could not read file " + filePath);
+        }
+        stream.finish(onToken);
+    }
+};
+
+#include <unordered_map>
+#include <vector>
+#include <string>
+
+class MentionMatcher {
+    std::unordered_map<std::string, std::vector<size_t>> dictionary;
+    std::vector<size_t> slotCompany;
+    size_t maxSynonymLength;
+
+public:
+    explicit MentionMatcher(const std::vector<Company>& companies) : maxSynonymLength(0) {
+        for (size_t companyIndex = 0; companyIndex < companies.size(); ++companyIndex) {
+            for (const auto& synonym : companies[companyIndex].getSynonyms()) {
+                dictionary[synonym].push_back(slotCompany.size());
+                slotCompany.push_back(companyIndex);
+                maxSynonymLength = std::max(maxSynonymLength, synonym.size());
+            }
+        }
+    }
+
+    size_t slotCount() const {
+        return slotCompany.size();
+    }
+
+    size_t companyForSlot(size_t slot) const {
+        return slotCompany[slot];
+    }
+
+    // Один прохід по тексту: кількість входжень для кожного синоніму кожної компанії
+    std::vector<int> countSynonymsRaw(std::string_view rawText) const {
+        std::vector<int> counts(slotCompany.size(), 0);
+        TextAnalyzer::forEachToken(rawText, [&](const std::string& word) { credit(word, counts); }, maxSynonymLength);
+        return counts;
+    }
+
+    std::vector<int> countSynonymsInFile(const std::string& filePath, size_t chunkSize, ContentHash* hash = nullptr) const {
+        std::vector<int> counts(slotCompany.size(), 0);
+        TextAnalyzer::forEachTokenInFile(filePath, chunkSize, [&](const std::string& word) { credit(word, counts); }, maxSynonymLength, hash);
+        return counts;
+    }
+
+    // Відбиток словника: кеш, створений з іншим набором синонімів, недійсний
+    std::uint64_t signature() const {
+        ContentHash hash;
+        std::vector<std::pair<size_t, const std::string*>> slots(slotCompany.size());
+        for (const auto& entry : dictionary) {
+            for (size_t slot : entry.second) {
+                slots[slot] = {slotCompany[slot], &entry.first};
+            }
+        }
+        for (const auto& slot : slots) {
+            hash.update(std::to_string(slot.first));
+            hash.update(std::string_view(slot.second->c_str(), slot.second->size() + 1));
+        }
+        return hash.value();
+    }
+
+private:
+    void credit(const std::string& word, std::vector<int>& counts) const {
+        auto it = dictionary.find(word);
+        if (it != dictionary.end()) {
+            for (size_t slot : it->second) {
+                counts[slot]++;
+            }
+        }
+    }
 };
 
 #include <iostream>
@@ -74,9 +429,185 @@ public:
 #include <vector>
 #include <string>
 #include <filesystem>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace fs = std::filesystem;
 
+class MappedFile {
+    void* data;
+    size_t size;
+
+public:
+    explicit MappedFile(const std::string& filePath) : data(nullptr), size(0) {
+        int fd = ::open(filePath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open file " + filePath);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not stat file " + filePath);
+        }
+        size = static_cast<size_t>(info.st_size);
+        if (size > 0) {
+            data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                data = nullptr;
+                ::close(fd);
+                throw std::runtime_error("Could not map file " + filePath);
+            }
+            ::madvise(data, size, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+    }
+
+    MappedFile(MappedFile&& other) noexcept : data(other.data), size(other.size) {
+        other.data = nullptr;
+        other.size = 0;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    ~MappedFile() {
+        if (data) {
+            ::munmap(data, size);
+        }
+    }
+
+    std::string_view view() const {
+        return data ? std::string_view(static_cast<const char*>(data), size) : std::string_view();
+    }
+};
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <fnmatch.h>
+
+struct DiscoveryOptions {
+    // Шаблони у стилі shell; шаблон зі '/' порівнюється з відносним шляхом, інакше з іменем файлу
+    std::vector<std::string> include = {"*.txt"};
+    std::vector<std::string> exclude;
+    bool recursive = true;
+    size_t threadCount = std::thread::hardware_concurrency();
+};
+
+class FileDiscovery {
+public:
+    // Паралельний обхід: кожен потік бере наступну директорію зі спільної черги.
+    // onFile викликається з різних потоків одразу після знаходження файлу.
+    template <typename Sink>
+    static void discover(const std::string& rootPath, const DiscoveryOptions& options, Sink&& onFile) {
+        if (!fs::is_directory(rootPath)) {
+            throw std::runtime_error("Could not open directory " + rootPath);
+        }
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<std::pair<fs::path, std::string>> directories;
+        directories.emplace_back(fs::path(rootPath), std::string());
+        size_t active = 0;
+        std::exception_ptr failure;
+
+        auto worker = [&]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&]() { return !directories.empty() || active == 0; });
+                if (directories.empty()) {
+                    return;
+                }
+                auto directory = std::move(directories.front());
+                directories.pop_front();
+                ++active;
+                lock.unlock();
+
+                std::vector<std::pair<fs::path, std::string>> subdirectories;
+                try {
+                    scanDirectory(directory.first, directory.second, options, onFile, subdirectories);
+                } catch (...) {
+                    lock.lock();
+                    if (!failure) {
+                        failure = std::current_exception();
+                    }
+                    directories.clear();
+                    subdirectories.clear();
+                    lock.unlock();
+                }
+
+                lock.lock();
+                for (auto& subdirectory : subdirectories) {
+                    directories.push_back(std::move(subdirectory));
+                }
+                --active;
+                wake.notify_all();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < std::max<size_t>(options.threadCount, 1); ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    static bool matches(const std::vector<std::string>& patterns, const std::string& name, const std::string& relativePath) {
+        for (const auto& pattern : patterns) {
+            const std::string& subject = pattern.find('/') != std::string::npos ? relativePath : name;
+            if (::fnmatch(pattern.c_str(), subject.c_str(), 0) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    template <typename Sink>
+    static void scanDirectory(const fs::path& directory, const std::string& relativeDirectory, const DiscoveryOptions& options,
+                              Sink& onFile, std::vector<std::pair<fs::path, std::string>>& subdirectories) {
+        std::error_code ec;
+        fs::directory_iterator it(directory, ec);
+        if (ec) {
+            return;
+        }
+        for (; it != fs::directory_iterator(); it.increment(ec)) {
+            if (ec) {
+                return;
+            }
+            const fs::directory_entry& entry = *it;
+            std::string name = entry.path().filename().string();
+            std::string relativePath = relativeDirectory.empty() ? name : relativeDirectory + "/" + name;
+            if (matches(options.exclude, name, relativePath)) {
+                continue;
+            }
+            std::error_code statError;
+            if (entry.is_directory(statError)) {
+                // Символьні посилання на директорії не обходимо, щоб уникнути циклів
+                if (options.recursive && !entry.is_symlink(statError)) {
+                    subdirectories.emplace_back(entry.path(), relativePath);
+                }
+            } else if (entry.is_regular_file(statError) && matches(options.include, name, relativePath)) {
+                std::uintmax_t size = entry.file_size(statError);
+                onFile(entry.path().string(), statError ? 0 : size);
+            }
+        }
+    }
+};
+
 class FileManager {
 public:
     static std::vector<std::string> readTextFiles(const std::string& directoryPath) {
@@ -99,57 +630,716 @@ public:
         file.close();
         return content;
     }
+
+    static MappedFile mapFile(const std::string& filePath) {
+        return MappedFile(filePath);
+    }
 };
 
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <string>
+#include <string_view>
+
+enum class ReportFormat {
+    Pretty,
+    Compact,
+    NDJson
+};
+
+// Буферизований вивід у файл: дані накопичуються в пам'яті і скидаються блоками
+class BufferedWriter {
+    std::ofstream file;
+    std::string buffer;
+    size_t capacity;
+    std::string filePath;
+
+public:
+    explicit BufferedWriter(const std::string& filePath, size_t capacity = 1 << 20)
+        : file(filePath, std::ios::binary | std::ios::trunc), capacity(capacity), filePath(filePath) {
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file " + filePath);
+        }
+        buffer.reserve(capacity);
+    }
+
+    void write(std::string_view data) {
+        if (buffer.size() + data.size() > capacity) {
+            flush();
+        }
+        if (data.size() > capacity) {
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        } else {
+            buffer.append(data.data(), data.size());
+        }
+    }
+
+    void put(char c) {
+        if (buffer.size() == capacity) {
+            flush();
+        }
+        buffer.push_back(c);
+    }
+
+    void flush() {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+        if (!file) {
+            throw std::runtime_error("Could not write file " + filePath);
+        }
+    }
+
+    void close() {
+        flush();
+        file.close();
+    }
+};
 
 class ReportGenerator {
 public:
-    static void generateReport(const std::vector<Company>& companies, const std::string& outputFilePath) {
-        json report;
-        for (const auto& company : companies) {
-            report.push_back(company.toJson());
+    // Звіт пишеться потоково, без побудови дерева json; Pretty і Compact збігаються з dump(4) і dump()
+    static void generateReport(const std::vector<Company>& companies, const std::string& outputFilePath, ReportFormat format = ReportFormat::Pretty) {
+        BufferedWriter out(outputFilePath);
+        bool pretty = format == ReportFormat::Pretty;
+
+        if (format != ReportFormat::NDJson) {
+            out.put('[');
+        }
+        for (size_t i = 0; i < companies.size(); ++i) {
+            if (format == ReportFormat::NDJson) {
+                writeCompany(out, companies[i], false, 0);
+                out.put('\n');
+                continue;
+            }
+            if (i > 0) {
+                out.put(',');
+            }
+            newline(out, pretty, 1);
+            writeCompany(out, companies[i], pretty, 1);
+        }
+        if (format != ReportFormat::NDJson) {
+            if (!companies.empty()) {
+                newline(out, pretty, 0);
+            }
+            out.put(']');
+        }
+        out.close();
+    }
+
+private:
+    static void writeCompany(BufferedWriter& out, const Company& company, bool pretty, int depth) {
+        out.put('{');
+        writeKey(out, "files_mentioned", pretty, depth + 1);
+        writeFileArray(out, company.getFileIds(), pretty, depth + 1);
+        out.put(',');
+        writeKey(out, "mentions", pretty, depth + 1);
+        out.write(std::to_string(company.getMentions()));
+        out.put(',');
+        writeKey(out, "official_name", pretty, depth + 1);
+        writeString(out, company.getOfficialName());
+        out.put(',');
+        writeKey(out, "synonyms", pretty, depth + 1);
+        writeStringArray(out, company.getSynonyms(), pretty, depth + 1);
+        newline(out, pretty, depth);
+        out.put('}');
+    }
+
+    static void writeKey(BufferedWriter& out, const char* key, bool pretty, int depth) {
+        newline(out, pretty, depth);
+        writeString(out, key);
+        out.write(pretty ? ": " : ":");
+    }
+
+    static void writeStringArray(BufferedWriter& out, const std::vector<std::string>& values, bool pretty, int depth) {
+        out.put('[');
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i > 0) {
+                out.put(',');
+            }
+            newline(out, pretty, depth + 1);
+            writeString(out, values[i]);
+        }
+        if (!values.empty()) {
+            newline(out, pretty, depth);
+        }
+        out.put(']');
+    }
+
+    static void writeFileArray(BufferedWriter& out, const std::vector<std::uint32_t>& fileIds, bool pretty, int depth) {
+        const PathTable& paths = PathTable::global();
+        out.put('[');
+        for (size_t i = 0; i < fileIds.size(); ++i) {
+            if (i > 0) {
+                out.put(',');
+            }
+            newline(out, pretty, depth + 1);
+            writeString(out, paths.path(fileIds[i]));
+        }
+        if (!fileIds.empty()) {
+            newline(out, pretty, depth);
+        }
+        out.put(']');
+    }
+
+    static void newline(BufferedWriter& out, bool pretty, int depth) {
+        if (pretty) {
+            static const std::string indent(64, ' ');
+            out.put('\n');
+            for (size_t width = static_cast<size_t>(depth) * 4; width > 0; width -= std::min(width, indent.size())) {
+                out.write(std::string_view(indent.data(), std::min(width, indent.size())));
+            }
         }
+    }
 
-        std::ofstream file(outputFilePath);
+    // Екранування як у nlohmann::json: керуючі символи як \uXXXX, UTF-8 без змін
+    static void writeString(BufferedWriter& out, std::string_view value) {
+        static const char hex[] = "0123456789abcdef";
+        out.put('"');
+        for (char c : value) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            switch (c) {
+                case '"': out.write("\\\""); break;
+                case '\\': out.write("\\\\"); break;
+                case '\b': out.write("\\b"); break;
+                case '\f': out.write("\\f"); break;
+                case '\n': out.write("\\n"); break;
+                case '\r': out.write("\\r"); break;
+                case '\t': out.write("\\t"); break;
+                default:
+                    if (byte < 0x20) {
+                        char escaped[] = {'\\', 'u', '0', '0', hex[byte >> 4], hex[byte & 0xF]};
+                        out.write(std::string_view(escaped, sizeof(escaped)));
+                    } else {
+                        out.put(c);
+                    }
+            }
+        }
+        out.put('"');
+    }
+};
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Персистентний кеш результатів по файлах: шлях -> (розмір, mtime, хеш вмісту, лічильники синонімів).
+// Файл із тим самим розміром і mtime не перечитується; якщо змінився лише mtime, звіряється хеш.
+class ScanCache {
+    struct Entry {
+        std::uintmax_t size = 0;
+        std::int64_t mtime = 0;
+        std::uint64_t hash = 0;
+        std::vector<std::pair<std::uint32_t, int>> counts;
+        bool seen = false;
+    };
+
+    static constexpr const char* header = "mention-cache 1";
+
+    std::string cachePath;
+    std::uint64_t signature;
+    size_t slotCount;
+    std::unordered_map<std::string, Entry> entries;
+    mutable std::mutex mutex;
+
+public:
+    ScanCache(const std::string& cachePath, std::uint64_t signature, size_t slotCount)
+        : cachePath(cachePath), signature(signature), slotCount(slotCount) {}
+
+    void load() {
+        std::ifstream file(cachePath, std::ios::binary);
         if (!file.is_open()) {
-            throw std::runtime_error("Could not open file " + outputFilePath);
+            return;
+        }
+        std::string line;
+        if (!std::getline(file, line) || line != std::string(header) + " " + std::to_string(signature)) {
+            return;
+        }
+        // Формат рядка: size mtime hash n slot count ... path.
+        // Пошкоджений рядок (не число, зайва кількість пар, слот поза словником) відкидається.
+        while (std::getline(file, line)) {
+            const char* cursor = line.c_str();
+            char* end = nullptr;
+            Entry entry;
+            entry.size = std::strtoull(cursor, &end, 10);
+            bool valid = end != cursor;
+            cursor = end;
+            entry.mtime = std::strtoll(cursor, &end, 10);
+            valid = valid && end != cursor;
+            cursor = end;
+            entry.hash = std::strtoull(cursor, &end, 10);
+            valid = valid && end != cursor;
+            cursor = end;
+            unsigned long pairs = std::strtoul(cursor, &end, 10);
+            valid = valid && end != cursor && pairs <= slotCount && pairs <= std::strlen(end) / 4;
+            for (unsigned long i = 0; valid && i < pairs; ++i) {
+                cursor = end;
+                unsigned long slot = std::strtoul(cursor, &end, 10);
+                valid = end != cursor && slot < slotCount;
+                cursor = end;
+                long count = std::strtol(cursor, &end, 10);
+                valid = valid && end != cursor;
+                entry.counts.emplace_back(static_cast<std::uint32_t>(slot), static_cast<int>(count));
+            }
+            if (!valid || *end != ' ') {
+                continue;
+            }
+            entries[std::string(end + 1)] = std::move(entry);
         }
+    }
 
-        file << report.dump(4);
-        file.close();
+    // Зберігає лише файли, побачені в цьому запуску; запис атомарний через rename
+    void save() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string tempPath = cachePath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                throw std::runtime_error("Could not open file " + tempPath);
+            }
+            file << header << " " << signature << "\n";
+            for (const auto& item : entries) {
+                const Entry& entry = item.second;
+                if (!entry.seen) {
+                    continue;
+                }
+                file << entry.size << " " << entry.mtime << " " << entry.hash << " " << entry.counts.size();
+                for (const auto& count : entry.counts) {
+                    file << " " << count.first << " " << count.second;
+                }
+                file << " " << item.first << "\n";
+            }
+            if (!file) {
+                throw std::runtime_error("Could not write file " + tempPath);
+            }
+        }
+        if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+            throw std::runtime_error("Could not replace file " + cachePath);
+        }
+    }
+
+    bool lookup(const std::string& filePath, std::uintmax_t size, std::int64_t mtime, std::vector<int>& counts) {
+        std::uint64_t expectedHash;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(filePath);
+            if (it == entries.end() || it->second.size != size) {
+                return false;
+            }
+            if (it->second.mtime == mtime) {
+                fill(it->second, counts);
+                return true;
+            }
+            expectedHash = it->second.hash;
+        }
+
+        MappedFile content = FileManager::mapFile(filePath);
+        ContentHash hash;
+        hash.update(content.view());
+        if (hash.value() != expectedHash) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry& entry = entries[filePath];
+        entry.mtime = mtime;
+        fill(entry, counts);
+        return true;
+    }
+
+    void store(const std::string& filePath, std::uintmax_t size, std::int64_t mtime, std::uint64_t hash, const std::vector<int>& counts) {
+        Entry entry;
+        entry.size = size;
+        entry.mtime = mtime;
+        entry.hash = hash;
+        entry.seen = true;
+        for (size_t slot = 0; slot < counts.size(); ++slot) {
+            if (counts[slot] > 0) {
+                entry.counts.emplace_back(static_cast<std::uint32_t>(slot), counts[slot]);
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        entries[filePath] = std::move(entry);
+    }
+
+private:
+    static void fill(Entry& entry, std::vector<int>& counts) {
+        entry.seen = true;
+        for (const auto& count : entry.counts) {
+            if (count.first < counts.size()) {
+                counts[count.first] = count.second;
+            }
+        }
     }
 };
 
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
-int main() {
-    std::vector<Company> companies = {
-        Company("Google", {"google", "goog"}),
-        Company("Apple", {"apple", "appl"})
+struct ScanOptions {
+    size_t threadCount = std::thread::hardware_concurrency();
+    // Розмір блоку для потокового читання великих файлів
+    size_t chunkSize = 1 << 20;
+    // Файли, більші за цей поріг, читаються блоками замість mmap
+    std::uintmax_t streamThreshold = std::uintmax_t(1) << 30;
+    // Шлях до персистентного кешу; порожній рядок вимикає кеш
+    std::string cachePath;
+};
+
+class ScanEngine {
+    struct Task {
+        size_t index;
+        std::string path;
+        std::uintmax_t size;
     };
 
-    std::string directoryPath = "./texts";
-    std::vector<std::string> files = FileManager::readTextFiles(directoryPath);
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Стан одного запуску: черги воркерів, зареєстровані файли та сигнал про нову роботу.
+    // Файли можна додавати, поки воркери вже працюють; close() означає, що нових не буде.
+    struct RunState {
+        std::vector<WorkerQueue> queues;
+        std::mutex filesMutex;
+        std::vector<std::uint32_t> fileIds;
+        std::mutex wakeMutex;
+        std::condition_variable wake;
+        std::atomic<size_t> pending{0};
+        bool closed = false;
+        std::atomic<bool> stop{false};
+        std::mutex failureMutex;
+        std::exception_ptr failure;
 
-    for (const auto& file : files) {
-        std::string content = FileManager::readFileContent(file);
-        std::string processedText = TextAnalyzer::preprocessText(content);
+        explicit RunState(size_t workers) : queues(workers) {}
+
+        void submit(const std::string& path, std::uintmax_t size) {
+            if (stop.load(std::memory_order_relaxed)) {
+                return;
+            }
+            std::uint32_t fileId = PathTable::global().intern(path);
+            size_t index;
+            {
+                std::lock_guard<std::mutex> lock(filesMutex);
+                index = fileIds.size();
+                fileIds.push_back(fileId);
+            }
+            WorkerQueue& queue = queues[index % queues.size()];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(Task{index, path, size});
+            }
+            pending.fetch_add(1);
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            wake.notify_one();
+        }
 
-        for (auto& company : companies) {
-            for (const auto& synonym : company.getSynonyms()) {
-                int mentions = TextAnalyzer::countMentions(processedText, synonym);
-                if (mentions > 0) {
-                    company.addMention(file);
+        void close() {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            closed = true;
+            wake.notify_all();
+        }
+
+        void fail(std::exception_ptr error) {
+            {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) {
+                    failure = error;
                 }
             }
+            stop = true;
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            wake.notify_all();
+        }
+    };
+
+    const MentionMatcher& matcher;
+    ScanOptions options;
+
+public:
+    explicit ScanEngine(const MentionMatcher& matcher, const ScanOptions& options = ScanOptions())
+        : matcher(matcher), options(options) {
+        this->options.threadCount = std::max<size_t>(this->options.threadCount, 1);
+    }
+
+    void run(const std::vector<std::string>& files, std::vector<Company>& companies) const {
+        RunState state(std::min(options.threadCount, std::max<size_t>(files.size(), 1)));
+
+        // Великі файли роздаються першими, дрібні залишаються в хвостах черг для крадіжки
+        std::vector<std::pair<std::uintmax_t, size_t>> bySize;
+        bySize.reserve(files.size());
+        for (size_t i = 0; i < files.size(); ++i) {
+            std::error_code ec;
+            std::uintmax_t size = fs::file_size(files[i], ec);
+            bySize.emplace_back(ec ? 0 : size, i);
+        }
+        std::sort(bySize.begin(), bySize.end(), std::greater<>());
+
+        std::vector<size_t> rank(files.size());
+        for (size_t i = 0; i < bySize.size(); ++i) {
+            rank[i] = bySize[i].second;
+            state.submit(files[bySize[i].second], bySize[i].first);
+        }
+        state.close();
+
+        execute(state, companies, rank);
+    }
+
+    // Пошук файлів і аналіз ідуть одночасно: знайдені шляхи одразу потрапляють у черги воркерів
+    void run(const std::string& rootPath, const DiscoveryOptions& discovery, std::vector<Company>& companies) const {
+        RunState state(options.threadCount);
+        std::thread producer([&]() {
+            try {
+                FileDiscovery::discover(rootPath, discovery, [&](const std::string& path, std::uintmax_t size) {
+                    state.submit(path, size);
+                });
+            } catch (...) {
+                state.fail(std::current_exception());
+            }
+            state.close();
+        });
+        std::vector<std::vector<std::vector<size_t>>> localHits;
+        std::unique_ptr<ScanCache> cache = openCache();
+        work(state, companies.size(), cache.get(), localHits);
+        producer.join();
+
+        // Порядок обходу паралельний і недетермінований, тому звіт впорядковується за шляхом
+        const PathTable& paths = PathTable::global();
+        std::vector<size_t> order(state.fileIds.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return paths.path(state.fileIds[a]) < paths.path(state.fileIds[b]); });
+        std::vector<size_t> rank(order.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            rank[order[i]] = i;
+        }
+        finish(state, companies, cache.get(), localHits, rank);
+    }
+
+private:
+    void execute(RunState& state, std::vector<Company>& companies, const std::vector<size_t>& rank) const {
+        std::vector<std::vector<std::vector<size_t>>> localHits;
+        std::unique_ptr<ScanCache> cache = openCache();
+        work(state, companies.size(), cache.get(), localHits);
+        finish(state, companies, cache.get(), localHits, rank);
+    }
+
+    std::unique_ptr<ScanCache> openCache() const {
+        std::unique_ptr<ScanCache> cache;
+        if (!options.cachePath.empty()) {
+            cache = std::make_unique<ScanCache>(options.cachePath, matcher.signature(), matcher.slotCount());
+            cache->load();
+        }
+        return cache;
+    }
+
+    // Локальні для потоку лічильники: індекси файлів для кожної компанії
+    void work(RunState& state, size_t companyCount, ScanCache* cache, std::vector<std::vector<std::vector<size_t>>>& localHits) const {
+        size_t workers = state.queues.size();
+        localHits.assign(workers, std::vector<std::vector<size_t>>(companyCount));
+
+        auto worker = [&](size_t self) {
+            try {
+                Task task;
+                while (nextTask(state, self, task)) {
+                    std::vector<int> counts = scanFile(task.path, task.size, cache);
+                    for (size_t slot = 0; slot < counts.size(); ++slot) {
+                        if (counts[slot] > 0) {
+                            localHits[self][matcher.companyForSlot(slot)].push_back(task.index);
+                        }
+                    }
+                }
+            } catch (...) {
+                state.fail(std::current_exception());
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < workers; ++i) {
+            threads.emplace_back(worker, i);
+        }
+        worker(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void finish(RunState& state, std::vector<Company>& companies, ScanCache* cache,
+                const std::vector<std::vector<std::vector<size_t>>>& localHits, const std::vector<size_t>& rank) const {
+        if (state.failure) {
+            std::rethrow_exception(state.failure);
+        }
+
+        for (size_t companyIndex = 0; companyIndex < companies.size(); ++companyIndex) {
+            std::vector<size_t> hits;
+            for (const auto& local : localHits) {
+                hits.insert(hits.end(), local[companyIndex].begin(), local[companyIndex].end());
+            }
+            std::sort(hits.begin(), hits.end(), [&](size_t a, size_t b) { return rank[a] < rank[b]; });
+            for (size_t fileIndex : hits) {
+                companies[companyIndex].addMention(state.fileIds[fileIndex]);
+            }
+        }
+
+        // Кеш лише прискорює наступний запуск, тож помилка запису не зупиняє сканування
+        if (cache) {
+            try {
+                cache->save();
+            } catch (const std::runtime_error& e) {
+                std::cerr << e.what() << ", cache not saved" << std::endl;
+            }
+        }
+    }
+
+    std::vector<int> scanFile(const std::string& filePath, std::uintmax_t fileSize, ScanCache* cache) const {
+        if (!cache) {
+            return scanContent(filePath, fileSize, nullptr);
+        }
+
+        std::int64_t mtime = fs::last_write_time(filePath).time_since_epoch().count();
+        std::vector<int> counts(matcher.slotCount(), 0);
+        if (cache->lookup(filePath, fileSize, mtime, counts)) {
+            return counts;
+        }
+        ContentHash hash;
+        counts = scanContent(filePath, fileSize, &hash);
+        cache->store(filePath, fileSize, mtime, hash.value(), counts);
+        return counts;
+    }
+
+    std::vector<int> scanContent(const std::string& filePath, std::uintmax_t fileSize, ContentHash* hash) const {
+        if (fileSize > options.streamThreshold) {
+            return matcher.countSynonymsInFile(filePath, options.chunkSize, hash);
+        }
+        MappedFile content = FileManager::mapFile(filePath);
+        if (hash) {
+            hash->update(content.view());
+        }
+        return matcher.countSynonymsRaw(content.view());
+    }
+
+    // Власна черга спорожняється з голови, чужі обкрадаються з хвоста.
+    // Якщо роботи немає, воркер чекає, доки з'явиться новий файл або запуск буде закрито.
+    static bool nextTask(RunState& state, size_t self, Task& task) {
+        while (!state.stop.load(std::memory_order_relaxed)) {
+            if (tryTake(state, self, task)) {
+                state.pending.fetch_sub(1);
+                return true;
+            }
+            std::unique_lock<std::mutex> lock(state.wakeMutex);
+            state.wake.wait(lock, [&]() { return state.pending.load() > 0 || state.closed || state.stop.load(); });
+            if (state.closed && state.pending.load() == 0) {
+                return false;
+            }
         }
+        return false;
     }
 
+    static bool tryTake(RunState& state, size_t self, Task& task) {
+        auto& queues = state.queues;
+        {
+            std::lock_guard<std::mutex> lock(queues[self].mutex);
+            if (!queues[self].tasks.empty()) {
+                task = std::move(queues[self].tasks.front());
+                queues[self].tasks.pop_front();
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < queues.size(); ++offset) {
+            WorkerQueue& victim = queues[(self + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Мікробенчмарк: попередня реалізація preprocessText проти однопрохідного ядра
+void runNormalizeBenchmark(size_t textSize, int iterations) {
+    auto legacyPreprocess = [](const std::string& text) {
+        std::string processedText = text;
+        std::transform(processedText.begin(), processedText.end(), processedText.begin(), ::tolower);
+        processedText.erase(std::remove_if(processedText.begin(), processedText.end(), ::ispunct), processedText.end());
+        return processedText;
+    };
+
+    const std::string alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789     \n.,;:!?-'\"()";
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::string text(textSize, ' ');
+    for (auto& c : text) {
+        c = alphabet[pick(rng)];
+    }
+
+    auto measure = [&](const char* name, auto&& preprocess) {
+        size_t checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            checksum += preprocess(text).size();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        double megabytes = static_cast<double>(textSize) * iterations / (1024.0 * 1024.0);
+        std::cout << name << ": " << elapsed.count() << " s, " << megabytes / elapsed.count() << " MB/s (checksum " << checksum << ")" << std::endl;
+    };
+
+    if (legacyPreprocess(text) != TextAnalyzer::preprocessText(text)) {
+        throw std::runtime_error("Normalization kernel does not match the reference implementation");
+    }
+    measure("transform + remove_if", legacyPreprocess);
+    measure("scalar single pass", [](const std::string& t) {
+        std::string out(t.size(), '\0');
+        out.resize(TextNormalizer::normalizeScalar(t.data(), t.size(), out.data()));
+        return out;
+    });
+    measure("dispatched SIMD", TextAnalyzer::preprocessText);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench-normalize") {
+        runNormalizeBenchmark(16 * 1024 * 1024, 10);
+        return 0;
+    }
+
+    std::vector<Company> companies = {
+        Company("Google", {"google", "goog"}),
+        Company("Apple", {"apple", "appl"})
+    };
+
+    std::string directoryPath = "./texts";
+    MentionMatcher matcher(companies);
+
+    ScanOptions options;
+    // Кеш поруч зі звітом, а не в корпусі: корпус може бути доступний лише для читання
+    options.cachePath = ".mention_cache";
+    ScanEngine engine(matcher, options);
+    engine.run(directoryPath, DiscoveryOptions(), companies);
+
     ReportGenerator::generateReport(companies, "report.json");
 
     std::cout << "Report generated: report.json" << std::endl;
@@ -5,7 +5,29 @@
 #include <sstream>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <iterator>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // Визначте макрос для спрощення створення структур дати та часу
 #define DATE_FORMAT "%Y-%m-%dT%H:%M:%S"
@@ -65,24 +87,167 @@ public:
         return j;
     }
 
-private:
-    // Допоміжні функції для аналізу та форматування дат, статусів і тривалості
-    static std::chrono::system_clock::time_point parse_date(const std::string& date) {
-        std::tm tm = {};
-        std::istringstream ss(date);
-        ss >> std::get_time(&tm, DATE_FORMAT);
-        return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+    // Поля в порядку JSON-ключів; використовується потоковим завантажувачем
+    static constexpr size_t field_count = 10;
+
+    static const char* field_name(size_t index) {
+        static const char* const names[field_count] = {
+            "FlightNumber", "Airline", "Destination", "DepartureTime", "ArrivalTime",
+            "Gate", "Status", "Duration", "AircraftType", "Terminal"
+        };
+        return names[index];
+    }
+
+    static int field_index(const std::string& key) {
+        for (size_t i = 0; i < field_count; ++i) {
+            if (key == field_name(i)) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    void set_field(int index, const std::string& value) {
+        switch (index) {
+            case 0: FlightNumber = value; break;
+            case 1: Airline = value; break;
+            case 2: Destination = value; break;
+            case 3: DepartureTime = parse_date(value); break;
+            case 4: ArrivalTime = parse_date(value); break;
+            case 5: Gate = value; break;
+            case 6: Status = parse_status(value); break;
+            case 7: Duration = parse_duration(value); break;
+            case 8: AircraftType = value; break;
+            case 9: Terminal = value; break;
+            default: throw std::invalid_argument("Invalid flight field");
+        }
+    }
+
+    // Допоміжні функції для аналізу та форматування дат, статусів і тривалості.
+    // Дати у форматі DATE_FORMAT розбираються вручну як UTC: без локалі, часового поясу,
+    // виділення пам'яті та глобальних блокувань, тож їх можна викликати з багатьох потоків.
+    // Рядок має точно відповідати формату: суфікс поясу чи будь-які зайві символи - помилка.
+    static constexpr size_t date_buffer_size = 32;
+
+    static std::chrono::system_clock::time_point parse_date(std::string_view date) {
+        if (date.size() != 19 || date[4] != '-' || date[7] != '-' || date[10] != 'T' || date[13] != ':' || date[16] != ':') {
+            throw std::invalid_argument("Invalid date");
+        }
+        int year = parse_digits(date, 0, 4);
+        int month = parse_digits(date, 5, 2);
+        int day = parse_digits(date, 8, 2);
+        int hour = parse_digits(date, 11, 2);
+        int minute = parse_digits(date, 14, 2);
+        int second = parse_digits(date, 17, 2);
+        if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month) || hour > 23 || minute > 59 || second > 60) {
+            throw std::invalid_argument("Invalid date");
+        }
+        std::int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+        return std::chrono::system_clock::time_point(std::chrono::seconds(seconds));
+    }
+
+    // Записує дату в out (щонайменше date_buffer_size байтів) і повертає довжину
+    static size_t format_date(const std::chrono::system_clock::time_point& tp, char* out) {
+        std::int64_t seconds = std::chrono::floor<std::chrono::seconds>(tp.time_since_epoch()).count();
+        std::int64_t days = floor_div(seconds, 86400);
+        std::int64_t rest = seconds - days * 86400;
+        int year, month, day;
+        civil_from_days(days, year, month, day);
+        char* p = out;
+        if (year >= 0 && year <= 9999) {
+            p = write_digits(p, year, 4);
+        } else {
+            p = write_integer(p, year);
+        }
+        *p++ = '-';
+        p = write_digits(p, month, 2);
+        *p++ = '-';
+        p = write_digits(p, day, 2);
+        *p++ = 'T';
+        p = write_digits(p, static_cast<int>(rest / 3600), 2);
+        *p++ = ':';
+        p = write_digits(p, static_cast<int>(rest / 60 % 60), 2);
+        *p++ = ':';
+        p = write_digits(p, static_cast<int>(rest % 60), 2);
+        return static_cast<size_t>(p - out);
     }
 
     static std::string format_date(const std::chrono::system_clock::time_point& tp) {
-        std::time_t t = std::chrono::system_clock::to_time_t(tp);
-        std::tm tm = *std::localtime(&t);
-        std::ostringstream ss;
-        ss << std::put_time(&tm, DATE_FORMAT);
-        return ss.str();
+        char buffer[date_buffer_size];
+        return std::string(buffer, format_date(tp, buffer));
+    }
+
+    // Номер дня від 1970-01-01 для дати григоріанського календаря (алгоритм days_from_civil)
+    static std::int64_t days_from_civil(int year, int month, int day) {
+        year -= month <= 2;
+        std::int64_t era = floor_div(year, 400);
+        std::int64_t year_of_era = year - era * 400;
+        std::int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        std::int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + day_of_era - 719468;
+    }
+
+    static int days_in_month(int year, int month) {
+        static constexpr int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        return month == 2 && leap ? 29 : days[month - 1];
+    }
+
+    static void civil_from_days(std::int64_t days, int& year, int& month, int& day) {
+        days += 719468;
+        std::int64_t era = floor_div(days, 146097);
+        std::int64_t day_of_era = days - era * 146097;
+        std::int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+        std::int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+        std::int64_t mp = (5 * day_of_year + 2) / 153;
+        day = static_cast<int>(day_of_year - (153 * mp + 2) / 5 + 1);
+        month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        year = static_cast<int>(year_of_era + era * 400 + (month <= 2));
+    }
+
+private:
+    static std::int64_t floor_div(std::int64_t value, std::int64_t divisor) {
+        return value / divisor - (value % divisor < 0);
+    }
+
+    static int parse_digits(std::string_view text, size_t offset, size_t count) {
+        int value = 0;
+        for (size_t i = offset; i < offset + count; ++i) {
+            if (text[i] < '0' || text[i] > '9') {
+                throw std::invalid_argument("Invalid date");
+            }
+            value = value * 10 + (text[i] - '0');
+        }
+        return value;
+    }
+
+    static char* write_integer(char* out, long long value) {
+        char digits[20];
+        unsigned long long magnitude = value < 0 ? 0ull - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (value < 0) {
+            *out++ = '-';
+        }
+        while (count > 0) {
+            *out++ = digits[--count];
+        }
+        return out;
+    }
+
+    static char* write_digits(char* out, int value, int width) {
+        for (int i = width - 1; i >= 0; --i) {
+            out[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        return out + width;
     }
 
-    static FlightStatus parse_status(const std::string& status) {
+public:
+    static FlightStatus parse_status(std::string_view status) {
         if (status == "OnTime") return FlightStatus::OnTime;
         if (status == "Delayed") return FlightStatus::Delayed;
         if (status == "Cancelled") return FlightStatus::Cancelled;
@@ -102,134 +267,1974 @@ private:
         }
     }
 
-    static std::chrono::duration<double> parse_duration(const std::string& duration) {
-        int hours, minutes, seconds;
-        sscanf(duration.c_str(), "%d:%d:%d", &hours, &minutes, &seconds);
-        return std::chrono::hours(hours) + std::chrono::minutes(minutes) + std::chrono::seconds(seconds);
+    // Тривалість у форматі "H:M:S" (без доповнення нулями, години можуть перевищувати 24); зайві символи - помилка
+    static std::chrono::duration<double> parse_duration(std::string_view duration) {
+        long long parts[3];
+        const char* p = duration.data();
+        const char* end = p + duration.size();
+        for (int i = 0; i < 3; ++i) {
+            auto result = std::from_chars(p, end, parts[i]);
+            if (result.ec != std::errc() || (i < 2 ? result.ptr == end || *result.ptr != ':' : result.ptr != end)) {
+                throw std::invalid_argument("Invalid duration");
+            }
+            p = result.ptr + (i < 2 ? 1 : 0);
+        }
+        return std::chrono::hours(parts[0]) + std::chrono::minutes(parts[1]) + std::chrono::seconds(parts[2]);
     }
 
-    static std::string format_duration(const std::chrono::duration<double>& duration) {
+    static constexpr size_t duration_buffer_size = 64;
+
+    // Записує тривалість в out (щонайменше duration_buffer_size байтів) і повертає довжину
+    static size_t format_duration(const std::chrono::duration<double>& duration, char* out) {
         auto hrs = std::chrono::duration_cast<std::chrono::hours>(duration).count();
         auto mins = std::chrono::duration_cast<std::chrono::minutes>(duration).count() % 60;
         auto secs = std::chrono::duration_cast<std::chrono::seconds>(duration).count() % 60;
-        std::ostringstream ss;
-        ss << hrs << ":" << mins << ":" << secs;
-        return ss.str();
+        char* p = write_integer(out, hrs);
+        *p++ = ':';
+        p = write_integer(p, mins);
+        *p++ = ':';
+        p = write_integer(p, secs);
+        return static_cast<size_t>(p - out);
+    }
+
+    static std::string format_duration(const std::chrono::duration<double>& duration) {
+        char buffer[duration_buffer_size];
+        return std::string(buffer, format_duration(duration, buffer));
     }
 };
 
-// FlightInformationSystem Class
-class FlightInformationSystem {
+// MappedFile: файл, відображений у пам'ять лише для читання
+class MappedFile {
 public:
-    // Function to read flight data from a JSON file
-    void read_flights_from_json(const std::string& filename) {
-        std::ifstream file(filename);
-        nlohmann::json json_data;
-        file >> json_data;
-        for (const auto& flight_data : json_data["flights"]) {
-            flights.push_back(Flight::from_json(flight_data));
+    explicit MappedFile(const std::string& filename) : data(nullptr), size(0) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open file " + filename);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not stat file " + filename);
+        }
+        size = static_cast<size_t>(info.st_size);
+        if (size > 0) {
+            data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED) {
+                data = nullptr;
+                ::close(fd);
+                throw std::runtime_error("Could not map file " + filename);
+            }
         }
+        ::close(fd);
     }
 
-    // Функція для отримання всіх рейсів
-    const std::vector<Flight>& get_all_flights() const {
-        return flights;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data) {
+            ::munmap(data, size);
+        }
     }
 
+    const char* begin() const { return static_cast<const char*>(data); }
+    const char* end() const { return begin() + size; }
+    size_t length() const { return size; }
+
 private:
-    std::vector<Flight> flights;
+    void* data;
+    size_t size;
 };
 
-// FlightQueryHandler Class
-class FlightQueryHandler {
+// Column: колонка значень, що або належить об'єкту, або є переглядом у відображений у пам'ять знімок.
+// Копії колонки ділять один буфер; перша зміна спільного чи переглядового буфера копіює його (copy-on-write),
+// тож копія всієї системи коштує O(кількість колонок), а не O(кількість рядків).
+template <typename T>
+class Column {
 public:
-    FlightQueryHandler(const FlightInformationSystem& system) : system(system) {}
+    Column() : view(nullptr), count(0) {}
 
-    // Function to get all flights of a specific airline, sorted by departure time
-    std::vector<Flight> get_flights_by_airline(const std::string& airline) const {
-        std::vector<Flight> result;
-        for (const auto& flight : system.get_all_flights()) {
-            if (flight.Airline == airline) {
-                result.push_back(flight);
-            }
+    Column(const Column&) = default;
+    Column& operator=(const Column&) = default;
+
+    Column(Column&& other) noexcept : owned(std::move(other.owned)), view(other.view), count(other.count) {
+        other.view = nullptr;
+        other.count = 0;
+    }
+
+    Column& operator=(Column&& other) noexcept {
+        if (this != &other) {
+            owned = std::move(other.owned);
+            view = other.view;
+            count = other.count;
+            other.view = nullptr;
+            other.count = 0;
         }
-        std::sort(result.begin(), result.end(), [](const Flight& a, const Flight& b) {
-            return a.DepartureTime < b.DepartureTime;
-        });
-        return result;
+        return *this;
+    }
+
+    static Column map(const T* data, size_t size) {
+        Column column;
+        column.view = data;
+        column.count = size;
+        return column;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T* data() const { return view; }
+    const T* begin() const { return view; }
+    const T* end() const { return view + count; }
+    const T& operator[](size_t i) const { return view[i]; }
+    const T& back() const { return view[count - 1]; }
+
+    void assign(std::vector<T> values) {
+        owned = std::make_shared<std::vector<T>>(std::move(values));
+        sync();
+    }
+
+    void push_back(const T& value) {
+        detach().push_back(value);
+        sync();
+    }
+
+    void append(const T* first, const T* last) {
+        std::vector<T>& values = detach();
+        values.insert(values.end(), first, last);
+        sync();
+    }
+
+    void set(size_t i, const T& value) {
+        detach()[i] = value;
+    }
+
+    void insert(size_t position, const T& value) {
+        std::vector<T>& values = detach();
+        values.insert(values.begin() + static_cast<std::ptrdiff_t>(position), value);
+        sync();
+    }
+
+    void erase(size_t position) {
+        std::vector<T>& values = detach();
+        values.erase(values.begin() + static_cast<std::ptrdiff_t>(position));
+        sync();
+    }
+
+private:
+    std::shared_ptr<std::vector<T>> owned;
+    const T* view;
+    size_t count;
+
+    // Буфер, який можна змінювати: переглядовий або спільний з іншою копією спершу копіюється
+    std::vector<T>& detach() {
+        if (!owned || owned.use_count() > 1) {
+            owned = std::make_shared<std::vector<T>>(view, view + count);
+            sync();
+        }
+        return *owned;
+    }
+
+    void sync() {
+        view = owned->data();
+        count = owned->size();
+    }
+};
+
+// Бінарний знімок: заголовок, таблиця секцій і вирівняні секції з колонками фіксованої ширини.
+// Знімок відображається в пам'ять лише для читання, тож процеси ділять одні й ті самі сторінки.
+enum class SnapshotSection : std::uint32_t {
+    NumberChars,
+    NumberOffsets,
+    AirlineCodes,
+    DestinationCodes,
+    Departures,
+    Arrivals,
+    GateCodes,
+    Statuses,
+    Durations,
+    AircraftCodes,
+    TerminalCodes,
+    AirlineStrings,
+    AirlineStringOffsets,
+    DestinationStrings,
+    DestinationStringOffsets,
+    GateStrings,
+    GateStringOffsets,
+    AircraftStrings,
+    AircraftStringOffsets,
+    TerminalStrings,
+    TerminalStringOffsets,
+    DepartureOrder,
+    ArrivalOrder,
+    AirlinePostings,
+    AirlinePostingOffsets,
+    DestinationPostings,
+    DestinationPostingOffsets,
+    StatusPostings,
+    StatusPostingOffsets,
+    DelayOrder,
+    Count
+};
+
+// Розмір і час зміни вихідного JSON: знімок актуальний, лише поки вони збігаються
+// (порівняння часів "новіший/старший" обманюють cp -p, tar і rsync -t)
+struct SnapshotSource {
+    std::uint64_t size;
+    std::int64_t mtime;
+
+    static SnapshotSource of(const std::string& filename, std::error_code& error) {
+        SnapshotSource source = {};
+        std::uintmax_t size = std::filesystem::file_size(filename, error);
+        if (error) {
+            return source;
+        }
+        auto mtime = std::filesystem::last_write_time(filename, error);
+        if (error) {
+            return source;
+        }
+        source.size = size;
+        source.mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count());
+        return source;
+    }
+
+    bool operator==(const SnapshotSource& other) const { return size == other.size && mtime == other.mtime; }
+    bool operator!=(const SnapshotSource& other) const { return !(*this == other); }
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t rows;
+    std::uint64_t sections;
+    SnapshotSource source;
+};
+
+struct SnapshotSectionEntry {
+    std::uint64_t offset;
+    std::uint64_t bytes;
+};
+
+constexpr char snapshot_magic[8] = {'F', 'L', 'T', 'S', 'N', 'A', 'P', '\0'};
+constexpr std::uint32_t snapshot_version = 3;
+constexpr std::uint32_t snapshot_byte_order = 0x01020304;
+constexpr std::uint64_t snapshot_alignment = 64;
+
+class SnapshotWriter {
+public:
+    template <typename T>
+    void add(SnapshotSection id, const T* data, size_t count) {
+        sections[static_cast<size_t>(id)] = {reinterpret_cast<const char*>(data), count * sizeof(T)};
+    }
+
+    template <typename T>
+    void add(SnapshotSection id, const Column<T>& column) {
+        add(id, column.data(), column.size());
     }
 
-    // Функція для отримання всіх затриманих рейсів, відсортованих за часом затримки
-    std::vector<Flight> get_delayed_flights() const {
-        std::vector<Flight> result;
-        for (const auto& flight : system.get_all_flights()) {
-            if (flight.Status == FlightStatus::Delayed) {
-                result.push_back(flight);
+    // Дані, які треба зібрати лише для запису (рядки словників, CSR-списки індексів)
+    template <typename T>
+    void add_owned(SnapshotSection id, std::vector<T> values) {
+        auto buffer = std::make_shared<std::vector<T>>(std::move(values));
+        owned.push_back(buffer);
+        add(id, buffer->data(), buffer->size());
+    }
+
+    void commit(const std::string& filename, std::uint64_t rows, const SnapshotSource& source) const {
+        SnapshotHeader header = {};
+        std::copy(std::begin(snapshot_magic), std::end(snapshot_magic), header.magic);
+        header.version = snapshot_version;
+        header.byte_order = snapshot_byte_order;
+        header.rows = rows;
+        header.sections = sections.size();
+        header.source = source;
+
+        std::vector<SnapshotSectionEntry> entries(sections.size());
+        std::uint64_t offset = align(sizeof(SnapshotHeader) + sizeof(SnapshotSectionEntry) * entries.size());
+        for (size_t i = 0; i < sections.size(); ++i) {
+            entries[i] = {offset, sections[i].second};
+            offset = align(offset + sections[i].second);
+        }
+
+        std::string temp = filename + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                throw std::runtime_error("Could not open file " + temp);
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(sizeof(SnapshotSectionEntry) * entries.size()));
+            std::uint64_t position = sizeof(SnapshotHeader) + sizeof(SnapshotSectionEntry) * entries.size();
+            static const char padding[snapshot_alignment] = {};
+            for (size_t i = 0; i < sections.size(); ++i) {
+                file.write(padding, static_cast<std::streamsize>(entries[i].offset - position));
+                file.write(sections[i].first, static_cast<std::streamsize>(sections[i].second));
+                position = entries[i].offset + sections[i].second;
+            }
+            if (!file) {
+                throw std::runtime_error("Could not write file " + temp);
             }
         }
-        std::sort(result.begin(), result.end(), [](const Flight& a, const Flight& b) {
-            return a.DepartureTime < b.DepartureTime;
-        });
-        return result;
+        if (std::rename(temp.c_str(), filename.c_str()) != 0) {
+            throw std::runtime_error("Could not replace file " + filename);
+        }
     }
 
-    // Функція для отримання всіх рейсів на певний день, відсортованих за часом вильоту
-    std::vector<Flight> get_flights_by_day(const std::tm& day) const {
-        std::vector<Flight> result;
-        for (const auto& flight : system.get_all_flights()) {
-            std::time_t dep_time_t = std::chrono::system_clock::to_time_t(flight.DepartureTime);
-            std::tm* dep_time_tm = std::localtime(&dep_time_t);
-            if (dep_time_tm->tm_year == day.tm_year && dep_time_tm->tm_mon == day.tm_mon && dep_time_tm->tm_mday == day.tm_mday) {
-                result.push_back(flight);
+private:
+    std::vector<std::pair<const char*, std::uint64_t>> sections = std::vector<std::pair<const char*, std::uint64_t>>(static_cast<size_t>(SnapshotSection::Count));
+    std::vector<std::shared_ptr<void>> owned;
+
+    static std::uint64_t align(std::uint64_t offset) {
+        return (offset + snapshot_alignment - 1) / snapshot_alignment * snapshot_alignment;
+    }
+};
+
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::string& filename) : file(std::make_shared<MappedFile>(filename)) {
+        if (file->length() < sizeof(SnapshotHeader)) {
+            throw std::runtime_error("Invalid snapshot " + filename);
+        }
+        std::memcpy(&header, file->begin(), sizeof(header));
+        if (!std::equal(std::begin(snapshot_magic), std::end(snapshot_magic), header.magic) || header.version != snapshot_version ||
+            header.byte_order != snapshot_byte_order || header.sections != static_cast<std::uint64_t>(SnapshotSection::Count) ||
+            file->length() < sizeof(SnapshotHeader) + sizeof(SnapshotSectionEntry) * header.sections) {
+            throw std::runtime_error("Invalid snapshot " + filename);
+        }
+        entries.resize(header.sections);
+        std::memcpy(entries.data(), file->begin() + sizeof(SnapshotHeader), sizeof(SnapshotSectionEntry) * entries.size());
+        for (const auto& entry : entries) {
+            if (entry.offset % snapshot_alignment != 0 || entry.offset > file->length() || entry.bytes > file->length() - entry.offset) {
+                throw std::runtime_error("Invalid snapshot " + filename);
             }
         }
-        std::sort(result.begin(), result.end(), [](const Flight& a, const Flight& b) {
-            return a.DepartureTime < b.DepartureTime;
-        });
-        return result;
     }
 
-    // Функція для отримання всіх рейсів з певного часового інтервалу до певного пункту призначення, відсортованих за часом вильоту
-    std::vector<Flight> get_flights_in_interval_to_destination(const std::chrono::system_clock::time_point& start, const std::chrono::system_clock::time_point& end, const std::string& destination) const {
-        std::vector<Flight> result;
-        for (const auto& flight : system.get_all_flights()) {
-            if (flight.Destination == destination && flight.DepartureTime >= start && flight.DepartureTime <= end) {
-                result.push_back(flight);
+    std::uint64_t rows() const { return header.rows; }
+    const SnapshotSource& source() const { return header.source; }
+    const std::shared_ptr<MappedFile>& mapping() const { return file; }
+
+    template <typename T>
+    Column<T> column(SnapshotSection id) const {
+        const SnapshotSectionEntry& entry = entries[static_cast<size_t>(id)];
+        if (entry.bytes % sizeof(T) != 0) {
+            throw std::runtime_error("Invalid snapshot section");
+        }
+        return Column<T>::map(reinterpret_cast<const T*>(file->begin() + entry.offset), entry.bytes / sizeof(T));
+    }
+
+private:
+    std::shared_ptr<MappedFile> file;
+    SnapshotHeader header;
+    std::vector<SnapshotSectionEntry> entries;
+};
+
+// StringDictionary: кожне різне значення зберігається один раз, колонки містять лише його код
+class StringDictionary {
+public:
+    std::uint32_t encode(const std::string& value) {
+        auto it = codes.find(value);
+        if (it != codes.end()) {
+            return it->second;
+        }
+        std::uint32_t code = static_cast<std::uint32_t>(values.size());
+        values.push_back(value);
+        codes.emplace(value, code);
+        return code;
+    }
+
+    bool find(const std::string& value, std::uint32_t& code) const {
+        auto it = codes.find(value);
+        if (it == codes.end()) {
+            return false;
+        }
+        code = it->second;
+        return true;
+    }
+
+    const std::string& decode(std::uint32_t code) const { return values[code]; }
+    size_t size() const { return values.size(); }
+
+    void save(SnapshotWriter& writer, SnapshotSection strings, SnapshotSection offsets) const {
+        std::vector<char> chars;
+        std::vector<std::uint64_t> bounds = {0};
+        for (const auto& value : values) {
+            chars.insert(chars.end(), value.begin(), value.end());
+            bounds.push_back(chars.size());
+        }
+        writer.add_owned(strings, std::move(chars));
+        writer.add_owned(offsets, std::move(bounds));
+    }
+
+    static StringDictionary load(const SnapshotReader& reader, SnapshotSection strings, SnapshotSection offsets) {
+        Column<char> chars = reader.column<char>(strings);
+        Column<std::uint64_t> bounds = reader.column<std::uint64_t>(offsets);
+        StringDictionary dictionary;
+        for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+            if (bounds[i] > bounds[i + 1] || bounds[i + 1] > chars.size()) {
+                throw std::runtime_error("Invalid snapshot dictionary");
             }
+            dictionary.encode(std::string(chars.data() + bounds[i], chars.data() + bounds[i + 1]));
         }
-        std::sort(result.begin(), result.end(), [](const Flight& a, const Flight& b) {
-            return a.DepartureTime < b.DepartureTime;
-        });
-        return result;
+        return dictionary;
     }
 
-    // Функція для отримання всіх рейсів, що прибули за останню годину або протягом певного часового інтервалу, відсортованих за часом прибуття
-    std::vector<Flight> get_flights_arriving_recently_or_interval(const std::chrono::system_clock::time_point& start, const std::chrono::system_clock::time_point& end) const {
-        std::vector<Flight> result;
-        for (const auto& flight : system.get_all_flights()) {
-            if (flight.ArrivalTime >= start && flight.ArrivalTime <= end) {
-                result.push_back(flight);
+private:
+    std::vector<std::string> values;
+    std::unordered_map<std::string, std::uint32_t> codes;
+};
+
+// FlightTable: колонкове сховище рейсів (struct-of-arrays).
+// Рядки з малою кількістю значень закодовані словниками, час зберігається як int64 від епохи,
+// статус як один байт; номери рейсів лежать в одному суцільному буфері символів.
+class FlightTable {
+public:
+    using Row = std::uint32_t;
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    void append(const Flight& flight) {
+        number_offsets.push_back(static_cast<std::uint32_t>(number_chars.size()));
+        number_chars.append(flight.FlightNumber.data(), flight.FlightNumber.data() + flight.FlightNumber.size());
+        airline_codes.push_back(airline_dictionary.encode(flight.Airline));
+        destination_codes.push_back(destination_dictionary.encode(flight.Destination));
+        departures.push_back(flight.DepartureTime.time_since_epoch().count());
+        arrivals.push_back(flight.ArrivalTime.time_since_epoch().count());
+        gate_codes.push_back(gate_dictionary.encode(flight.Gate));
+        statuses.push_back(static_cast<std::uint8_t>(flight.Status));
+        durations.push_back(flight.Duration.count());
+        aircraft_codes.push_back(aircraft_dictionary.encode(flight.AircraftType));
+        terminal_codes.push_back(terminal_dictionary.encode(flight.Terminal));
+    }
+
+    size_t size() const { return departures.size(); }
+
+    std::string_view flight_number(Row row) const {
+        size_t begin = number_offsets[row];
+        size_t end = row + 1 < number_offsets.size() ? number_offsets[row + 1] : number_chars.size();
+        return std::string_view(number_chars.data() + begin, end - begin);
+    }
+
+    const std::string& airline(Row row) const { return airline_dictionary.decode(airline_codes[row]); }
+    const std::string& destination(Row row) const { return destination_dictionary.decode(destination_codes[row]); }
+    const std::string& gate(Row row) const { return gate_dictionary.decode(gate_codes[row]); }
+    const std::string& aircraft_type(Row row) const { return aircraft_dictionary.decode(aircraft_codes[row]); }
+    const std::string& terminal(Row row) const { return terminal_dictionary.decode(terminal_codes[row]); }
+    TimePoint departure_time(Row row) const { return to_time_point(departures[row]); }
+    TimePoint arrival_time(Row row) const { return to_time_point(arrivals[row]); }
+    FlightStatus status(Row row) const { return static_cast<FlightStatus>(statuses[row]); }
+    std::chrono::duration<double> duration(Row row) const { return std::chrono::duration<double>(durations[row]); }
+
+    // Затримка: фактичний час у дорозі мінус запланована тривалість, у секундах
+    double delay_seconds(Row row) const {
+        return std::chrono::duration<double>(TimePoint::duration(arrivals[row] - departures[row])).count() - durations[row];
+    }
+
+    Flight materialize(Row row) const {
+        Flight f;
+        f.FlightNumber = std::string(flight_number(row));
+        f.Airline = airline(row);
+        f.Destination = destination(row);
+        f.DepartureTime = departure_time(row);
+        f.ArrivalTime = arrival_time(row);
+        f.Gate = gate(row);
+        f.Status = status(row);
+        f.Duration = duration(row);
+        f.AircraftType = aircraft_type(row);
+        f.Terminal = terminal(row);
+        return f;
+    }
+
+    // Зміна рядка на місці; номер рейсу є ключем і не змінюється
+    void replace(Row row, const Flight& flight) {
+        airline_codes.set(row, airline_dictionary.encode(flight.Airline));
+        destination_codes.set(row, destination_dictionary.encode(flight.Destination));
+        set_times(row, flight.DepartureTime, flight.ArrivalTime);
+        set_gate(row, flight.Gate);
+        set_status(row, flight.Status);
+        durations.set(row, flight.Duration.count());
+        aircraft_codes.set(row, aircraft_dictionary.encode(flight.AircraftType));
+        terminal_codes.set(row, terminal_dictionary.encode(flight.Terminal));
+    }
+
+    void set_times(Row row, const TimePoint& departure, const TimePoint& arrival) {
+        departures.set(row, to_ticks(departure));
+        arrivals.set(row, to_ticks(arrival));
+    }
+
+    void set_gate(Row row, const std::string& gate) { gate_codes.set(row, gate_dictionary.encode(gate)); }
+    void set_status(Row row, FlightStatus status) { statuses.set(row, static_cast<std::uint8_t>(status)); }
+
+    // Колонки для щільних циклів фільтрації
+    const Column<std::int64_t>& departure_column() const { return departures; }
+    const Column<std::int64_t>& arrival_column() const { return arrivals; }
+    const Column<std::uint8_t>& status_column() const { return statuses; }
+    const Column<std::uint32_t>& airline_column() const { return airline_codes; }
+    const Column<std::uint32_t>& destination_column() const { return destination_codes; }
+    const StringDictionary& airlines() const { return airline_dictionary; }
+    const StringDictionary& destinations() const { return destination_dictionary; }
+
+    static std::int64_t to_ticks(const TimePoint& time) { return time.time_since_epoch().count(); }
+    static TimePoint to_time_point(std::int64_t ticks) { return TimePoint(TimePoint::duration(ticks)); }
+
+    void save(SnapshotWriter& writer) const {
+        writer.add(SnapshotSection::NumberChars, number_chars);
+        writer.add(SnapshotSection::NumberOffsets, number_offsets);
+        writer.add(SnapshotSection::AirlineCodes, airline_codes);
+        writer.add(SnapshotSection::DestinationCodes, destination_codes);
+        writer.add(SnapshotSection::Departures, departures);
+        writer.add(SnapshotSection::Arrivals, arrivals);
+        writer.add(SnapshotSection::GateCodes, gate_codes);
+        writer.add(SnapshotSection::Statuses, statuses);
+        writer.add(SnapshotSection::Durations, durations);
+        writer.add(SnapshotSection::AircraftCodes, aircraft_codes);
+        writer.add(SnapshotSection::TerminalCodes, terminal_codes);
+        airline_dictionary.save(writer, SnapshotSection::AirlineStrings, SnapshotSection::AirlineStringOffsets);
+        destination_dictionary.save(writer, SnapshotSection::DestinationStrings, SnapshotSection::DestinationStringOffsets);
+        gate_dictionary.save(writer, SnapshotSection::GateStrings, SnapshotSection::GateStringOffsets);
+        aircraft_dictionary.save(writer, SnapshotSection::AircraftStrings, SnapshotSection::AircraftStringOffsets);
+        terminal_dictionary.save(writer, SnapshotSection::TerminalStrings, SnapshotSection::TerminalStringOffsets);
+    }
+
+    // Колонки лишаються переглядами у знімок; словники (їх мало) копіюються в пам'ять
+    static FlightTable load(const SnapshotReader& reader) {
+        FlightTable table;
+        table.storage = reader.mapping();
+        table.number_chars = reader.column<char>(SnapshotSection::NumberChars);
+        table.number_offsets = reader.column<std::uint32_t>(SnapshotSection::NumberOffsets);
+        table.airline_codes = reader.column<std::uint32_t>(SnapshotSection::AirlineCodes);
+        table.destination_codes = reader.column<std::uint32_t>(SnapshotSection::DestinationCodes);
+        table.departures = reader.column<std::int64_t>(SnapshotSection::Departures);
+        table.arrivals = reader.column<std::int64_t>(SnapshotSection::Arrivals);
+        table.gate_codes = reader.column<std::uint32_t>(SnapshotSection::GateCodes);
+        table.statuses = reader.column<std::uint8_t>(SnapshotSection::Statuses);
+        table.durations = reader.column<double>(SnapshotSection::Durations);
+        table.aircraft_codes = reader.column<std::uint32_t>(SnapshotSection::AircraftCodes);
+        table.terminal_codes = reader.column<std::uint32_t>(SnapshotSection::TerminalCodes);
+        table.airline_dictionary = StringDictionary::load(reader, SnapshotSection::AirlineStrings, SnapshotSection::AirlineStringOffsets);
+        table.destination_dictionary = StringDictionary::load(reader, SnapshotSection::DestinationStrings, SnapshotSection::DestinationStringOffsets);
+        table.gate_dictionary = StringDictionary::load(reader, SnapshotSection::GateStrings, SnapshotSection::GateStringOffsets);
+        table.aircraft_dictionary = StringDictionary::load(reader, SnapshotSection::AircraftStrings, SnapshotSection::AircraftStringOffsets);
+        table.terminal_dictionary = StringDictionary::load(reader, SnapshotSection::TerminalStrings, SnapshotSection::TerminalStringOffsets);
+        table.validate(reader.rows());
+        return table;
+    }
+
+private:
+    std::shared_ptr<MappedFile> storage;
+    Column<char> number_chars;
+    Column<std::uint32_t> number_offsets;
+    Column<std::uint32_t> airline_codes;
+    Column<std::uint32_t> destination_codes;
+    Column<std::int64_t> departures;
+    Column<std::int64_t> arrivals;
+    Column<std::uint32_t> gate_codes;
+    Column<std::uint8_t> statuses;
+    Column<double> durations;
+    Column<std::uint32_t> aircraft_codes;
+    Column<std::uint32_t> terminal_codes;
+    StringDictionary airline_dictionary;
+    StringDictionary destination_dictionary;
+    StringDictionary gate_dictionary;
+    StringDictionary aircraft_dictionary;
+    StringDictionary terminal_dictionary;
+
+    // Перевірка знімка: усі колонки однакової довжини, коди та зсуви в межах
+    void validate(std::uint64_t rows) const {
+        bool valid = number_offsets.size() == rows && airline_codes.size() == rows && destination_codes.size() == rows &&
+                     departures.size() == rows && arrivals.size() == rows && gate_codes.size() == rows &&
+                     statuses.size() == rows && durations.size() == rows && aircraft_codes.size() == rows && terminal_codes.size() == rows;
+        for (size_t row = 0; valid && row < rows; ++row) {
+            valid = number_offsets[row] <= number_chars.size() && (row == 0 || number_offsets[row - 1] <= number_offsets[row]) &&
+                    airline_codes[row] < airline_dictionary.size() && destination_codes[row] < destination_dictionary.size() &&
+                    gate_codes[row] < gate_dictionary.size() && aircraft_codes[row] < aircraft_dictionary.size() &&
+                    terminal_codes[row] < terminal_dictionary.size() && statuses[row] <= static_cast<std::uint8_t>(FlightStatus::InFlight);
+        }
+        if (!valid) {
+            throw std::runtime_error("Invalid snapshot columns");
+        }
+    }
+};
+
+class FlightInformationSystem;
+
+// FlightRef: легкий дескриптор рейсу (система + номер рядка), нічого не копіює
+class FlightRef {
+public:
+    using Row = FlightTable::Row;
+
+    FlightRef(const FlightInformationSystem* system, Row row) : system(system), row_(row) {}
+
+    Row row() const { return row_; }
+    std::string_view flight_number() const;
+    std::string_view airline() const;
+    std::string_view destination() const;
+    std::chrono::system_clock::time_point departure_time() const;
+    std::chrono::system_clock::time_point arrival_time() const;
+    std::string_view gate() const;
+    FlightStatus status() const;
+    std::chrono::duration<double> duration() const;
+    std::string_view aircraft_type() const;
+    std::string_view terminal() const;
+
+    // Повна копія рейсу, коли вона справді потрібна
+    Flight to_flight() const;
+    nlohmann::json to_json() const { return to_flight().to_json(); }
+
+private:
+    const FlightInformationSystem* system;
+    Row row_;
+};
+
+// FlightRange: діапазон результатів запиту поверх індексу системи, без виділення пам'яті.
+// Дійсний, доки дані системи не перезавантажено.
+class FlightRange {
+public:
+    using Row = FlightTable::Row;
+
+    // Розіменування повертає FlightRef за значенням, тож це лише input-ітератор;
+    // довільний доступ - через operator[] і page() діапазону
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = FlightRef;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = FlightRef;
+
+        iterator(const FlightInformationSystem* system, const Row* position) : system(system), position(position) {}
+
+        FlightRef operator*() const { return FlightRef(system, *position); }
+        iterator& operator++() { ++position; return *this; }
+        iterator operator++(int) { iterator copy = *this; ++position; return copy; }
+        iterator& operator+=(difference_type n) { position += n; return *this; }
+        difference_type operator-(const iterator& other) const { return position - other.position; }
+        bool operator==(const iterator& other) const { return position == other.position; }
+        bool operator!=(const iterator& other) const { return position != other.position; }
+
+    private:
+        const FlightInformationSystem* system;
+        const Row* position;
+    };
+
+    FlightRange() : system(nullptr), first(nullptr), last(nullptr) {}
+    FlightRange(const FlightInformationSystem* system, const Row* first, const Row* last)
+        : system(system), first(first), last(last) {}
+
+    iterator begin() const { return iterator(system, first); }
+    iterator end() const { return iterator(system, last); }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+    FlightRef operator[](size_t i) const { return FlightRef(system, first[i]); }
+
+    // Пагінація: не більше limit результатів, починаючи з offset
+    FlightRange page(size_t offset, size_t limit) const {
+        const Row* page_first = first + std::min(offset, size());
+        const Row* page_last = page_first + std::min(limit, static_cast<size_t>(last - page_first));
+        return FlightRange(system, page_first, page_last);
+    }
+
+    std::vector<Flight> to_vector() const;
+
+private:
+    const FlightInformationSystem* system;
+    const Row* first;
+    const Row* last;
+};
+
+// FlightSaxHandler: будує рейси прямо з потоку токенів, без DOM-дерева.
+// Рейсом вважається кожен об'єкт у масиві "flights" кореневого об'єкта; невідомі ключі ігноруються.
+class FlightSaxHandler {
+public:
+    explicit FlightSaxHandler(FlightTable& table) : table(table) {}
+
+    bool null() { return scalar(); }
+    bool boolean(bool) { return scalar(); }
+    bool number_integer(nlohmann::json::number_integer_t) { return scalar(); }
+    bool number_unsigned(nlohmann::json::number_unsigned_t) { return scalar(); }
+    bool number_float(nlohmann::json::number_float_t, const nlohmann::json::string_t&) { return scalar(); }
+    bool binary(nlohmann::json::binary_t&) { return scalar(); }
+
+    bool string(nlohmann::json::string_t& value) {
+        if (in_flight_field()) {
+            current.set_field(field, value);
+            seen |= 1u << field;
+        }
+        flights_key = false;
+        return true;
+    }
+
+    bool start_object(std::size_t) {
+        ++depth;
+        if (flights_depth != 0 && depth == flights_depth + 1) {
+            current = Flight();
+            seen = 0;
+        }
+        flights_key = false;
+        return true;
+    }
+
+    bool key(nlohmann::json::string_t& value) {
+        if (depth == 1) {
+            flights_key = value == "flights";
+        } else if (flights_depth != 0 && depth == flights_depth + 1) {
+            field = Flight::field_index(value);
+        }
+        return true;
+    }
+
+    bool end_object() {
+        if (flights_depth != 0 && depth == flights_depth + 1) {
+            for (size_t i = 0; i < Flight::field_count; ++i) {
+                if (!(seen & (1u << i))) {
+                    throw std::invalid_argument(std::string("Missing flight field ") + Flight::field_name(i));
+                }
             }
+            table.append(current);
+            field = -1;
         }
-        std::sort(result.begin(), result.end(), [](const Flight& a, const Flight& b) {
-            return a.ArrivalTime < b.ArrivalTime;
-        });
-        return result;
+        --depth;
+        return true;
+    }
+
+    bool start_array(std::size_t) {
+        ++depth;
+        if (flights_key && depth == 2) {
+            flights_depth = depth;
+        }
+        flights_key = false;
+        return true;
+    }
+
+    bool end_array() {
+        if (depth == flights_depth) {
+            flights_depth = 0;
+        }
+        --depth;
+        return true;
+    }
+
+    // Шаблон зберігає конкретний тип винятку (json::parse_error тощо), як при розборі через DOM
+    template <typename Exception>
+    bool parse_error(std::size_t, const std::string&, const Exception& ex) {
+        throw ex;
     }
 
 private:
-    const FlightInformationSystem& system;
+    FlightTable& table;
+    Flight current;
+    int depth = 0;
+    int flights_depth = 0;
+    bool flights_key = false;
+    int field = -1;
+    unsigned seen = 0;
+
+    bool in_flight_field() const {
+        return flights_depth != 0 && depth == flights_depth + 1 && field >= 0;
+    }
+
+    bool scalar() {
+        if (in_flight_field()) {
+            throw std::invalid_argument(std::string("Invalid value for flight field ") + Flight::field_name(static_cast<size_t>(field)));
+        }
+        flights_key = false;
+        return true;
+    }
 };
 
-int main() {
-    FlightInformationSystem fis;
-    fis.read_flights_from_json("flights.json");
+// FlightInformationSystem Class
+class FlightInformationSystem {
+public:
+    using Row = FlightTable::Row;
+    using TimePoint = FlightTable::TimePoint;
+    using IndexRange = std::pair<const Row*, const Row*>;
+
+    // Function to read flight data from a JSON file
+    // Потокове (SAX) читання без DOM. Рейси розбираються в окрему таблицю і додаються в систему
+    // лише після успішного розбору всього файлу: при помилці система лишається без змін
+    void read_flights_from_json(const std::string& filename) {
+        MappedFile file(filename);
+        FlightTable parsed;
+        FlightSaxHandler handler(parsed);
+        nlohmann::json::sax_parse(file.begin(), file.end(), &handler);
+        if (table.size() == 0) {
+            table = std::move(parsed);
+        } else {
+            for (Row row = 0; row < parsed.size(); ++row) {
+                table.append(parsed.materialize(row));
+            }
+        }
+        build_indexes();
+    }
+
+    // Попередній шлях через DOM-дерево; залишено для порівняння у бенчмарку завантаження
+    void read_flights_from_json_dom(const std::string& filename) {
+        std::ifstream file(filename);
+        nlohmann::json json_data;
+        file >> json_data;
+        for (const auto& flight_data : json_data["flights"]) {
+            table.append(Flight::from_json(flight_data));
+        }
+        build_indexes();
+    }
+
+    // Функція для отримання всіх рейсів (матеріалізує копії з колонкового сховища)
+    std::vector<Flight> get_all_flights() const {
+        std::vector<Flight> flights;
+        flights.reserve(table.size());
+        for (Row row = 0; row < table.size(); ++row) {
+            flights.push_back(table.materialize(row));
+        }
+        return flights;
+    }
+
+    const FlightTable& get_table() const {
+        return table;
+    }
+
+    FlightRange range(const Column<Row>& index) const {
+        return FlightRange(this, index.data(), index.data() + index.size());
+    }
+
+    FlightRange range(const IndexRange& index) const {
+        return FlightRange(this, index.first, index.second);
+    }
+
+    // Індекси: номери рядків, кожен список уже відсортований за часом вильоту
+    const Column<Row>& flights_by_airline(const std::string& airline) const {
+        return lookup(airline_index, table.airlines(), airline);
+    }
+
+    const Column<Row>& flights_by_destination(const std::string& destination) const {
+        return lookup(destination_index, table.destinations(), destination);
+    }
+
+    const Column<Row>& flights_by_status(FlightStatus status) const {
+        return status_index[static_cast<size_t>(status)];
+    }
+
+    // Те саме за кодом словника, без декодування і повторного хешування рядка
+    const Column<Row>& flights_by_airline_code(std::uint32_t code) const {
+        return lookup(airline_index, code);
+    }
+
+    const Column<Row>& flights_by_destination_code(std::uint32_t code) const {
+        return lookup(destination_index, code);
+    }
+
+    // Затримані рейси від найбільшої затримки до найменшої (за рівної затримки - за вильотом);
+    // порядок будується при завантаженні й підтримується оновленнями, а не сортується при кожному запиті
+    const Column<Row>& delayed_by_delay() const {
+        return delay_order;
+    }
+
+    // Рейси з вильотом у [start, end], відсортовані за часом вильоту
+    IndexRange departures_between(const TimePoint& start, const TimePoint& end) const {
+        return time_range(departure_order, start, end, table.departure_column());
+    }
+
+    // Рейси з прибуттям у [start, end], відсортовані за часом прибуття
+    IndexRange arrivals_between(const TimePoint& start, const TimePoint& end) const {
+        return time_range(arrival_order, start, end, table.arrival_column());
+    }
+
+    // Календарні дні рахуються у фіксованому зсуві від UTC, а не в глобальному TZ процесу (за замовчуванням UTC).
+    // Зміна зсуву перебудовує кошики днів.
+    void set_utc_offset(std::chrono::minutes offset) {
+        utc_offset = offset;
+        build_day_buckets();
+    }
+
+    std::chrono::minutes get_utc_offset() const {
+        return utc_offset;
+    }
+
+    // Рейси з вильотом у календарний день (номер дня від 1970-01-01 у налаштованому поясі),
+    // відсортовані за часом вильоту: готовий відрізок порядку вильотів, без пошуку по часу
+    IndexRange departures_on_day(std::int64_t day) const {
+        const Row* begin = departure_order.data();
+        if (day < first_day || day - first_day + 1 >= static_cast<std::int64_t>(day_bounds.size())) {
+            return {begin, begin};
+        }
+        size_t i = static_cast<size_t>(day - first_day);
+        return {begin + day_bounds[i], begin + day_bounds[i + 1]};
+    }
+
+    // Звуження вже відсортованого за вильотом списку до інтервалу [start, end]
+    IndexRange departures_between(const Column<Row>& index, const TimePoint& start, const TimePoint& end) const {
+        return time_range(index, start, end, table.departure_column());
+    }
+
+    // Оновлення даних без перезавантаження: вставка або заміна рейсу за номером, зміна статусу, виходу чи часу.
+    // Індекси оновлюються точково (бінарний пошук і вставка у відсортований список), а не перебудовуються.
+    // Діапазони FlightRange, отримані до оновлення, стають недійсними.
+    Row upsert_flight(const Flight& flight) {
+        Row row;
+        if (find_row(flight.FlightNumber, row)) {
+            unindex(row);
+            table.replace(row, flight);
+        } else {
+            row = static_cast<Row>(table.size());
+            table.append(flight);
+            if (number_index.use_count() > 1) {
+                number_index = std::make_shared<std::unordered_map<std::string, Row>>(*number_index);
+            }
+            number_index->emplace(flight.FlightNumber, row);
+        }
+        index(row);
+        return row;
+    }
+
+    bool update_status(const std::string& flight_number, FlightStatus status) {
+        Row row;
+        if (!find_row(flight_number, row)) {
+            return false;
+        }
+        const auto& departures = table.departure_column();
+        erase_row(status_index[table.status_column()[row]], row, departures);
+        erase_delayed(row);
+        table.set_status(row, status);
+        insert_row(status_index[static_cast<size_t>(status)], row, departures);
+        insert_delayed(row);
+        return true;
+    }
+
+    bool update_gate(const std::string& flight_number, const std::string& gate) {
+        Row row;
+        if (!find_row(flight_number, row)) {
+            return false;
+        }
+        table.set_gate(row, gate);
+        return true;
+    }
+
+    bool update_times(const std::string& flight_number, const TimePoint& departure, const TimePoint& arrival) {
+        Row row;
+        if (!find_row(flight_number, row)) {
+            return false;
+        }
+        unindex(row);
+        table.set_times(row, departure, arrival);
+        index(row);
+        return true;
+    }
+
+    // Потік подій, по одному JSON-об'єкту на рядок:
+    //   {"Event": "upsert", <усі поля рейсу>}
+    //   {"Event": "status", "FlightNumber": ..., "Status": ...}
+    //   {"Event": "gate", "FlightNumber": ..., "Gate": ...}
+    //   {"Event": "time", "FlightNumber": ..., "DepartureTime": ..., "ArrivalTime": ...}
+    // Повертає кількість застосованих подій; події для невідомих рейсів пропускаються.
+    size_t apply_updates(std::istream& events) {
+        size_t applied = 0;
+        size_t line_number = 0;
+        std::string line;
+        while (std::getline(events, line)) {
+            ++line_number;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            try {
+                applied += apply_update(nlohmann::json::parse(line)) ? 1 : 0;
+            } catch (const std::exception& e) {
+                throw std::invalid_argument("Invalid update at line " + std::to_string(line_number) + ": " + e.what());
+            }
+        }
+        return applied;
+    }
+
+    // Файл або іменований канал (FIFO): читання блокується, доки постачальник не закриє потік
+    size_t apply_updates(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file " + filename);
+        }
+        return apply_updates(file);
+    }
+
+    // Запис бінарного знімка: колонки, словники та готові порядки сортування й індекси;
+    // source - відбиток JSON, з якого завантажено дані
+    void write_snapshot(const std::string& filename, const SnapshotSource& source = {}) const {
+        SnapshotWriter writer;
+        table.save(writer);
+        writer.add(SnapshotSection::DepartureOrder, departure_order);
+        writer.add(SnapshotSection::ArrivalOrder, arrival_order);
+        save_postings(writer, airline_index, SnapshotSection::AirlinePostings, SnapshotSection::AirlinePostingOffsets);
+        save_postings(writer, destination_index, SnapshotSection::DestinationPostings, SnapshotSection::DestinationPostingOffsets);
+        save_postings(writer, status_index, SnapshotSection::StatusPostings, SnapshotSection::StatusPostingOffsets);
+        writer.add(SnapshotSection::DelayOrder, delay_order);
+        writer.commit(filename, table.size(), source);
+    }
+
+    // Теплий старт: знімок відображається в пам'ять, колонки та індекси читаються з нього без копіювання.
+    // Якщо задано expected, знімок іншого JSON відхиляється винятком.
+    void load_snapshot(const std::string& filename, const SnapshotSource* expected = nullptr) {
+        SnapshotReader reader(filename);
+        if (expected && reader.source() != *expected) {
+            throw std::runtime_error("Snapshot " + filename + " is out of date");
+        }
+        FlightTable loaded = FlightTable::load(reader);
+        Column<Row> departures = load_order(reader, SnapshotSection::DepartureOrder, loaded.size(), loaded.size());
+        Column<Row> arrivals = load_order(reader, SnapshotSection::ArrivalOrder, loaded.size(), loaded.size());
+        auto airlines = load_postings(reader, SnapshotSection::AirlinePostings, SnapshotSection::AirlinePostingOffsets, loaded.airlines().size(), loaded.size());
+        auto destinations = load_postings(reader, SnapshotSection::DestinationPostings, SnapshotSection::DestinationPostingOffsets, loaded.destinations().size(), loaded.size());
+        auto statuses = load_postings(reader, SnapshotSection::StatusPostings, SnapshotSection::StatusPostingOffsets, status_count, loaded.size());
+        Column<Row> delays = load_order(reader, SnapshotSection::DelayOrder, statuses[static_cast<size_t>(FlightStatus::Delayed)].size(), loaded.size());
+
+        table = std::move(loaded);
+        departure_order = std::move(departures);
+        arrival_order = std::move(arrivals);
+        airline_index = std::move(airlines);
+        destination_index = std::move(destinations);
+        status_index = std::move(statuses);
+        delay_order = std::move(delays);
+        number_index.reset();
+        build_day_buckets();
+    }
+
+private:
+    static constexpr size_t status_count = 5;
+
+    FlightTable table;
+    Column<Row> departure_order;
+    Column<Row> arrival_order;
+    std::vector<Column<Row>> airline_index;
+    std::vector<Column<Row>> destination_index;
+    std::vector<Column<Row>> status_index = std::vector<Column<Row>>(status_count);
+    Column<Row> delay_order;
+    // Кошики днів: day_bounds[i] - позиція в departure_order першого рейсу дня first_day + i
+    using Days = std::chrono::duration<std::int64_t, std::ratio<86400>>;
+    std::chrono::minutes utc_offset{0};
+    std::int64_t first_day = 0;
+    Column<std::uint32_t> day_bounds;
+    // Номер рейсу -> рядок; будується лише при першому оновленні і, як і колонки, ділиться між копіями
+    std::shared_ptr<std::unordered_map<std::string, Row>> number_index;
+
+    void build_indexes() {
+        departure_order.assign(sorted_order(table.departure_column()));
+        arrival_order.assign(sorted_order(table.arrival_column()));
+
+        const auto& airlines = table.airline_column();
+        const auto& destinations = table.destination_column();
+        const auto& statuses = table.status_column();
+        std::vector<std::vector<Row>> by_airline(table.airlines().size());
+        std::vector<std::vector<Row>> by_destination(table.destinations().size());
+        std::vector<std::vector<Row>> by_status(status_count);
+        for (Row row : departure_order) {
+            by_airline[airlines[row]].push_back(row);
+            by_destination[destinations[row]].push_back(row);
+            by_status[statuses[row]].push_back(row);
+        }
+        airline_index = to_columns(std::move(by_airline));
+        destination_index = to_columns(std::move(by_destination));
+        status_index = to_columns(std::move(by_status));
+        number_index.reset();
+        build_day_buckets();
+
+        const Column<Row>& delayed = status_index[static_cast<size_t>(FlightStatus::Delayed)];
+        std::vector<Row> by_delay(delayed.begin(), delayed.end());
+        std::sort(by_delay.begin(), by_delay.end(), [&](Row a, Row b) { return delay_before(a, b); });
+        delay_order.assign(std::move(by_delay));
+    }
+
+    // Порядок delay_order: більша затримка раніше, далі час вильоту і номер рядка
+    bool delay_before(Row a, Row b) const {
+        double delay_a = table.delay_seconds(a);
+        double delay_b = table.delay_seconds(b);
+        if (delay_a != delay_b) {
+            return delay_a > delay_b;
+        }
+        const auto& departures = table.departure_column();
+        if (departures[a] != departures[b]) {
+            return departures[a] < departures[b];
+        }
+        return a < b;
+    }
+
+    size_t delay_position(Row row) const {
+        return std::lower_bound(delay_order.begin(), delay_order.end(), row, [&](Row a, Row b) {
+            return delay_before(a, b);
+        }) - delay_order.begin();
+    }
+
+    void insert_delayed(Row row) {
+        if (table.status(row) == FlightStatus::Delayed) {
+            delay_order.insert(delay_position(row), row);
+        }
+    }
+
+    void erase_delayed(Row row) {
+        size_t i = delay_position(row);
+        if (table.status(row) == FlightStatus::Delayed && i < delay_order.size() && delay_order[i] == row) {
+            delay_order.erase(i);
+        }
+    }
+
+    std::int64_t local_day(std::int64_t ticks) const {
+        return std::chrono::floor<Days>(TimePoint::duration(ticks) + utc_offset).count();
+    }
+
+    std::int64_t day_start(std::int64_t day) const {
+        return FlightTable::to_ticks(TimePoint(Days(day) - utc_offset));
+    }
+
+    // Межі днів шукаються бінарним пошуком у порядку вильотів: O(днів * log n), тож дешево і після знімка
+    void build_day_buckets() {
+        std::vector<std::uint32_t> bounds;
+        const auto& departures = table.departure_column();
+        if (!departure_order.empty()) {
+            first_day = local_day(departures[departure_order[0]]);
+            std::int64_t last_day = local_day(departures[departure_order.back()]);
+            bounds.reserve(static_cast<size_t>(last_day - first_day + 2));
+            for (std::int64_t day = first_day; day <= last_day; ++day) {
+                std::int64_t start = day_start(day);
+                bounds.push_back(static_cast<std::uint32_t>(std::lower_bound(departure_order.begin(), departure_order.end(), start, [&](Row row, std::int64_t t) {
+                    return departures[row] < t;
+                }) - departure_order.begin()));
+            }
+            bounds.push_back(static_cast<std::uint32_t>(departure_order.size()));
+        }
+        day_bounds.assign(std::move(bounds));
+    }
+
+    // Після вставки чи вилучення рядка з departure_order зсуваються межі всіх наступних днів
+    void shift_day_buckets(Row row, bool inserted) {
+        std::int64_t day = local_day(table.departure_column()[row]);
+        if (day < first_day || day - first_day + 1 >= static_cast<std::int64_t>(day_bounds.size())) {
+            build_day_buckets();
+            return;
+        }
+        for (size_t i = static_cast<size_t>(day - first_day) + 1; i < day_bounds.size(); ++i) {
+            day_bounds.set(i, inserted ? day_bounds[i] + 1 : day_bounds[i] - 1);
+        }
+    }
+
+    bool apply_update(const nlohmann::json& event) {
+        const std::string& type = event.at("Event").get_ref<const std::string&>();
+        if (type == "upsert") {
+            upsert_flight(Flight::from_json(event));
+            return true;
+        }
+        const std::string& flight_number = event.at("FlightNumber").get_ref<const std::string&>();
+        if (type == "status") {
+            return update_status(flight_number, Flight::parse_status(event.at("Status").get_ref<const std::string&>()));
+        }
+        if (type == "gate") {
+            return update_gate(flight_number, event.at("Gate").get<std::string>());
+        }
+        if (type == "time") {
+            return update_times(flight_number, Flight::parse_date(event.at("DepartureTime").get_ref<const std::string&>()),
+                                Flight::parse_date(event.at("ArrivalTime").get_ref<const std::string&>()));
+        }
+        throw std::invalid_argument("Unknown event " + type);
+    }
+
+    // Якщо номер повторюється у вхідних даних, оновлюється перший рядок з ним
+    bool find_row(const std::string& flight_number, Row& row) {
+        if (!number_index) {
+            number_index = std::make_shared<std::unordered_map<std::string, Row>>();
+            number_index->reserve(table.size());
+            for (Row r = 0; r < table.size(); ++r) {
+                number_index->emplace(std::string(table.flight_number(r)), r);
+            }
+        }
+        auto it = number_index->find(flight_number);
+        if (it == number_index->end()) {
+            return false;
+        }
+        row = it->second;
+        return true;
+    }
+
+    // Вилучення рядка з усіх індексів за поточними значеннями його колонок
+    void unindex(Row row) {
+        const auto& departures = table.departure_column();
+        erase_row(departure_order, row, departures);
+        shift_day_buckets(row, false);
+        erase_row(arrival_order, row, table.arrival_column());
+        erase_row(airline_index[table.airline_column()[row]], row, departures);
+        erase_row(destination_index[table.destination_column()[row]], row, departures);
+        erase_row(status_index[table.status_column()[row]], row, departures);
+        erase_delayed(row);
+    }
+
+    void index(Row row) {
+        const auto& departures = table.departure_column();
+        airline_index.resize(table.airlines().size());
+        destination_index.resize(table.destinations().size());
+        insert_row(departure_order, row, departures);
+        shift_day_buckets(row, true);
+        insert_row(arrival_order, row, table.arrival_column());
+        insert_row(airline_index[table.airline_column()[row]], row, departures);
+        insert_row(destination_index[table.destination_column()[row]], row, departures);
+        insert_row(status_index[table.status_column()[row]], row, departures);
+        insert_delayed(row);
+    }
+
+    // Позиція рядка у списку, впорядкованому за (час, номер рядка), як після stable_sort
+    static size_t position(const Column<Row>& index, Row row, const Column<std::int64_t>& column) {
+        return std::lower_bound(index.begin(), index.end(), row, [&](Row a, Row b) {
+            return column[a] < column[b] || (column[a] == column[b] && a < b);
+        }) - index.begin();
+    }
+
+    static void insert_row(Column<Row>& index, Row row, const Column<std::int64_t>& column) {
+        index.insert(position(index, row, column), row);
+    }
+
+    static void erase_row(Column<Row>& index, Row row, const Column<std::int64_t>& column) {
+        size_t i = position(index, row, column);
+        if (i < index.size() && index[i] == row) {
+            index.erase(i);
+        }
+    }
+
+    static std::vector<Column<Row>> to_columns(std::vector<std::vector<Row>> lists) {
+        std::vector<Column<Row>> columns(lists.size());
+        for (size_t i = 0; i < lists.size(); ++i) {
+            columns[i].assign(std::move(lists[i]));
+        }
+        return columns;
+    }
+
+    // Списки індексу у форматі CSR: усі рядки підряд і зсуви початку кожного списку
+    static void save_postings(SnapshotWriter& writer, const std::vector<Column<Row>>& index, SnapshotSection rows, SnapshotSection offsets) {
+        std::vector<Row> all;
+        std::vector<std::uint64_t> bounds = {0};
+        for (const auto& list : index) {
+            all.insert(all.end(), list.begin(), list.end());
+            bounds.push_back(all.size());
+        }
+        writer.add_owned(rows, std::move(all));
+        writer.add_owned(offsets, std::move(bounds));
+    }
+
+    static Column<Row> load_order(const SnapshotReader& reader, SnapshotSection id, size_t size, size_t rows) {
+        Column<Row> order = reader.column<Row>(id);
+        if (order.size() != size || !std::all_of(order.begin(), order.end(), [&](Row row) { return row < rows; })) {
+            throw std::runtime_error("Invalid snapshot index");
+        }
+        return order;
+    }
+
+    static std::vector<Column<Row>> load_postings(const SnapshotReader& reader, SnapshotSection rows_id, SnapshotSection offsets_id, size_t keys, size_t rows) {
+        Column<Row> all = load_order(reader, rows_id, rows, rows);
+        Column<std::uint64_t> bounds = reader.column<std::uint64_t>(offsets_id);
+        if (bounds.size() != keys + 1 || bounds[0] != 0 || bounds[keys] != all.size()) {
+            throw std::runtime_error("Invalid snapshot index");
+        }
+        std::vector<Column<Row>> index(keys);
+        for (size_t key = 0; key < keys; ++key) {
+            if (bounds[key] > bounds[key + 1]) {
+                throw std::runtime_error("Invalid snapshot index");
+            }
+            index[key] = Column<Row>::map(all.data() + bounds[key], bounds[key + 1] - bounds[key]);
+        }
+        return index;
+    }
+
+    static std::vector<Row> sorted_order(const Column<std::int64_t>& column) {
+        std::vector<Row> order(column.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](Row a, Row b) {
+            return column[a] < column[b];
+        });
+        return order;
+    }
+
+    static IndexRange time_range(const Column<Row>& index, const TimePoint& start, const TimePoint& end, const Column<std::int64_t>& column) {
+        std::int64_t from = FlightTable::to_ticks(start);
+        std::int64_t to = FlightTable::to_ticks(end);
+        const Row* begin = index.data();
+        const Row* first = std::lower_bound(begin, begin + index.size(), from, [&](Row row, std::int64_t t) {
+            return column[row] < t;
+        });
+        const Row* last = std::upper_bound(first, begin + index.size(), to, [&](std::int64_t t, Row row) {
+            return t < column[row];
+        });
+        return {first, last};
+    }
+
+    static const Column<Row>& lookup(const std::vector<Column<Row>>& index, const StringDictionary& dictionary, const std::string& key) {
+        std::uint32_t code;
+        if (!dictionary.find(key, code)) {
+            code = static_cast<std::uint32_t>(index.size());
+        }
+        return lookup(index, code);
+    }
+
+    static const Column<Row>& lookup(const std::vector<Column<Row>>& index, std::uint32_t code) {
+        static const Column<Row> empty;
+        return code < index.size() ? index[code] : empty;
+    }
+};
+
+inline std::string_view FlightRef::flight_number() const { return system->get_table().flight_number(row_); }
+inline std::string_view FlightRef::airline() const { return system->get_table().airline(row_); }
+inline std::string_view FlightRef::destination() const { return system->get_table().destination(row_); }
+inline std::chrono::system_clock::time_point FlightRef::departure_time() const { return system->get_table().departure_time(row_); }
+inline std::chrono::system_clock::time_point FlightRef::arrival_time() const { return system->get_table().arrival_time(row_); }
+inline std::string_view FlightRef::gate() const { return system->get_table().gate(row_); }
+inline FlightStatus FlightRef::status() const { return system->get_table().status(row_); }
+inline std::chrono::duration<double> FlightRef::duration() const { return system->get_table().duration(row_); }
+inline std::string_view FlightRef::aircraft_type() const { return system->get_table().aircraft_type(row_); }
+inline std::string_view FlightRef::terminal() const { return system->get_table().terminal(row_); }
+inline Flight FlightRef::to_flight() const { return system->get_table().materialize(row_); }
+
+inline std::vector<Flight> FlightRange::to_vector() const {
+    std::vector<Flight> result;
+    result.reserve(size());
+    for (FlightRef flight : *this) {
+        result.push_back(flight.to_flight());
+    }
+    return result;
+}
+
+// FlightStore: сховище з версіями для одночасного читання під час оновлень (у стилі RCU).
+// Читачі отримують незмінний знімок системи і ніколи не чекають на записувача; записувач
+// застосовує пакет оновлень до копії (колонки діляться до першої зміни) і публікує її атомарно.
+// Старий знімок звільняється, коли його відпускає останній читач.
+class FlightStore {
+public:
+    using Snapshot = std::shared_ptr<const FlightInformationSystem>;
+
+    explicit FlightStore(FlightInformationSystem system)
+        : current(std::make_shared<const FlightInformationSystem>(std::move(system))), version(0) {}
+
+    Snapshot snapshot() const {
+        return std::atomic_load(&current);
+    }
+
+    std::uint64_t current_version() const {
+        return version.load(std::memory_order_acquire);
+    }
+
+    // Один пакет оновлень - одна нова версія; записувачі впорядковуються між собою м'ютексом
+    template <typename Update>
+    void update(Update&& apply) {
+        std::lock_guard<std::mutex> lock(writer);
+        auto next = std::make_shared<FlightInformationSystem>(*std::atomic_load(&current));
+        apply(*next);
+        std::atomic_store(&current, Snapshot(std::move(next)));
+        version.fetch_add(1, std::memory_order_release);
+    }
+
+    // Потік подій (формат як у FlightInformationSystem::apply_updates), публікується пакетами по batch_size подій
+    size_t apply_updates(std::istream& events, size_t batch_size = 1024) {
+        size_t applied = 0;
+        std::string line;
+        while (events) {
+            std::string batch;
+            size_t lines = 0;
+            while (lines < batch_size && std::getline(events, line)) {
+                batch += line;
+                batch += '\n';
+                ++lines;
+            }
+            if (lines == 0) {
+                break;
+            }
+            update([&](FlightInformationSystem& system) {
+                std::istringstream input(batch);
+                applied += system.apply_updates(input);
+            });
+        }
+        return applied;
+    }
+
+    // Читач потоку: тримає свій знімок і перечитує спільний вказівник лише коли змінилася версія,
+    // тож запити не торкаються спільного лічильника посилань
+    class Reader {
+    public:
+        explicit Reader(const FlightStore& store) : store(store), seen(store.current_version()), cached(store.snapshot()) {}
+
+        // Посилання дійсне до наступного виклику refresh()
+        const FlightInformationSystem& refresh() {
+            std::uint64_t latest = store.current_version();
+            if (latest != seen) {
+                seen = latest;
+                cached = store.snapshot();
+            }
+            return *cached;
+        }
+
+    private:
+        const FlightStore& store;
+        std::uint64_t seen;
+        Snapshot cached;
+    };
+
+private:
+    Snapshot current;
+    std::atomic<std::uint64_t> version;
+    std::mutex writer;
+};
+
+// Порядок результату get_delayed_flights
+enum class DelayedOrder {
+    ByDeparture,
+    ByDelay
+};
+
+// FlightQueryHandler Class
+class FlightQueryHandler {
+public:
+    FlightQueryHandler(const FlightInformationSystem& system) : system(system) {}
+
+    // Обробник, що утримує знімок FlightStore: результати лишаються узгодженими, поки живе обробник
+    FlightQueryHandler(FlightStore::Snapshot snapshot) : system(*snapshot), pinned(std::move(snapshot)) {}
+
+    // Function to get all flights of a specific airline, sorted by departure time
+    std::vector<Flight> get_flights_by_airline(const std::string& airline) const {
+        return view_flights_by_airline(airline).to_vector();
+    }
+
+    // Функція для отримання всіх затриманих рейсів, відсортованих за часом вильоту або за затримкою (від найбільшої)
+    std::vector<Flight> get_delayed_flights(DelayedOrder order = DelayedOrder::ByDeparture) const {
+        return view_delayed_flights(order).to_vector();
+    }
+
+    // Функція для отримання всіх рейсів на певний день, відсортованих за часом вильоту
+    std::vector<Flight> get_flights_by_day(const std::tm& day) const {
+        return view_flights_by_day(day).to_vector();
+    }
+
+    // Функція для отримання всіх рейсів з певного часового інтервалу до певного пункту призначення, відсортованих за часом вильоту
+    std::vector<Flight> get_flights_in_interval_to_destination(const std::chrono::system_clock::time_point& start, const std::chrono::system_clock::time_point& end, const std::string& destination) const {
+        return view_flights_in_interval_to_destination(start, end, destination).to_vector();
+    }
+
+    // Функція для отримання всіх рейсів, що прибули за останню годину або протягом певного часового інтервалу, відсортованих за часом прибуття
+    std::vector<Flight> get_flights_arriving_recently_or_interval(const std::chrono::system_clock::time_point& start, const std::chrono::system_clock::time_point& end) const {
+        return view_flights_arriving_recently_or_interval(start, end).to_vector();
+    }
+
+    // Ті самі запити без копіювання: діапазони дескрипторів у тому ж порядку
+    FlightRange view_flights_by_airline(const std::string& airline) const {
+        return system.range(system.flights_by_airline(airline));
+    }
+
+    FlightRange view_delayed_flights(DelayedOrder order = DelayedOrder::ByDeparture) const {
+        return system.range(order == DelayedOrder::ByDelay ? system.delayed_by_delay() : system.flights_by_status(FlightStatus::Delayed));
+    }
+
+    // День задається полями tm_year/tm_mon/tm_mday у поясі FlightInformationSystem::set_utc_offset;
+    // це пряме звернення до кошика дня, без localtime і глобального стану, тож безпечне з кількох потоків
+    FlightRange view_flights_by_day(const std::tm& day) const {
+        return system.range(system.departures_on_day(Flight::days_from_civil(day.tm_year + 1900, day.tm_mon + 1, day.tm_mday)));
+    }
+
+    FlightRange view_flights_in_interval_to_destination(const std::chrono::system_clock::time_point& start, const std::chrono::system_clock::time_point& end, const std::string& destination) const {
+        return system.range(system.departures_between(system.flights_by_destination(destination), start, end));
+    }
+
+    FlightRange view_flights_arriving_recently_or_interval(const std::chrono::system_clock::time_point& start, const std::chrono::system_clock::time_point& end) const {
+        return system.range(system.arrivals_between(start, end));
+    }
+
+    // Агрегатні запити для панелей моніторингу: рахуються на сервері за відсортованими індексами,
+    // без матеріалізації та повного сортування результатів
+
+    // Top-K: K найближчих вильотів, починаючи з моменту from (відрізок уже відсортованого порядку вильотів)
+    FlightRange view_next_departures(const std::chrono::system_clock::time_point& from, size_t k) const {
+        return system.range(system.departures_between(from, std::chrono::system_clock::time_point::max())).page(0, k);
+    }
+
+    FlightRange view_next_departures(const std::chrono::system_clock::time_point& from, size_t k, const std::string& airline) const {
+        return system.range(system.departures_between(system.flights_by_airline(airline), from, std::chrono::system_clock::time_point::max())).page(0, k);
+    }
+
+    // K рейсів з найбільшою затримкою
+    FlightRange view_most_delayed(size_t k) const {
+        return view_delayed_flights(DelayedOrder::ByDelay).page(0, k);
+    }
+
+    // Кількість рейсів з вильотом у [start, end] для кожної авіакомпанії / пункту призначення / статусу;
+    // кожне значення - різниця двох бінарних пошуків у списку індексу. Усі три повертають лише
+    // ненульові лічильники (у порядку кодів словника або переліку статусів).
+    std::vector<std::pair<std::string, size_t>> count_by_airline(const std::chrono::system_clock::time_point& start = std::chrono::system_clock::time_point::min(),
+                                                                 const std::chrono::system_clock::time_point& end = std::chrono::system_clock::time_point::max()) const {
+        const StringDictionary& airlines = system.get_table().airlines();
+        std::vector<std::pair<std::string, size_t>> counts;
+        for (std::uint32_t code = 0; code < airlines.size(); ++code) {
+            size_t count = count_between(system.flights_by_airline_code(code), start, end);
+            if (count > 0) {
+                counts.emplace_back(airlines.decode(code), count);
+            }
+        }
+        return counts;
+    }
+
+    std::vector<std::pair<std::string, size_t>> count_by_destination(const std::chrono::system_clock::time_point& start = std::chrono::system_clock::time_point::min(),
+                                                                     const std::chrono::system_clock::time_point& end = std::chrono::system_clock::time_point::max()) const {
+        const StringDictionary& destinations = system.get_table().destinations();
+        std::vector<std::pair<std::string, size_t>> counts;
+        for (std::uint32_t code = 0; code < destinations.size(); ++code) {
+            size_t count = count_between(system.flights_by_destination_code(code), start, end);
+            if (count > 0) {
+                counts.emplace_back(destinations.decode(code), count);
+            }
+        }
+        return counts;
+    }
+
+    std::vector<std::pair<FlightStatus, size_t>> count_by_status(const std::chrono::system_clock::time_point& start = std::chrono::system_clock::time_point::min(),
+                                                                 const std::chrono::system_clock::time_point& end = std::chrono::system_clock::time_point::max()) const {
+        std::vector<std::pair<FlightStatus, size_t>> counts;
+        for (FlightStatus status : {FlightStatus::OnTime, FlightStatus::Delayed, FlightStatus::Cancelled, FlightStatus::Boarding, FlightStatus::InFlight}) {
+            size_t count = count_between(system.flights_by_status(status), start, end);
+            if (count > 0) {
+                counts.emplace_back(status, count);
+            }
+        }
+        return counts;
+    }
+
+    // K найзавантаженіших пунктів призначення; часткове сортування лише K перших лічильників
+    std::vector<std::pair<std::string, size_t>> top_destinations(size_t k, const std::chrono::system_clock::time_point& start = std::chrono::system_clock::time_point::min(),
+                                                                 const std::chrono::system_clock::time_point& end = std::chrono::system_clock::time_point::max()) const {
+        auto counts = count_by_destination(start, end);
+        k = std::min(k, counts.size());
+        std::partial_sort(counts.begin(), counts.begin() + static_cast<std::ptrdiff_t>(k), counts.end(), [](const auto& a, const auto& b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        });
+        counts.resize(k);
+        return counts;
+    }
+
+    // Гістограма затримок затриманих рейсів: кошик i містить затримки з [i * width, (i + 1) * width),
+    // перший кошик - також від'ємні, останній - усі, що більші. Порядок за затримкою вже відсортований,
+    // тож межа кожного кошика знаходиться бінарним пошуком
+    std::vector<size_t> delay_histogram(std::chrono::minutes width, size_t buckets) const {
+        if (width.count() <= 0 || buckets == 0) {
+            throw std::invalid_argument("Invalid histogram shape");
+        }
+        const FlightTable& table = system.get_table();
+        const Column<FlightTable::Row>& delayed = system.delayed_by_delay();
+        // Кількість рейсів із затримкою не менше за limit секунд
+        auto at_least = [&](double limit) {
+            return static_cast<size_t>(std::partition_point(delayed.begin(), delayed.end(), [&](FlightTable::Row row) {
+                return table.delay_seconds(row) >= limit;
+            }) - delayed.begin());
+        };
+        std::vector<size_t> histogram(buckets);
+        size_t above = delayed.size();
+        for (size_t i = 0; i + 1 < buckets; ++i) {
+            size_t next = at_least(std::chrono::duration<double>(width * static_cast<std::int64_t>(i + 1)).count());
+            histogram[i] = above - next;
+            above = next;
+        }
+        histogram[buckets - 1] = above;
+        return histogram;
+    }
+
+private:
+    const FlightInformationSystem& system;
+    FlightStore::Snapshot pinned;
+
+    size_t count_between(const Column<FlightTable::Row>& index, const std::chrono::system_clock::time_point& start, const std::chrono::system_clock::time_point& end) const {
+        auto range = system.departures_between(index, start, end);
+        return static_cast<size_t>(range.second - range.first);
+    }
+};
+
+// Пікове використання пам'яті процесом (ru_maxrss у Linux - у кілобайтах)
+static double peak_rss_mb() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+}
+
+// Бенчмарк завантаження: SAX-завантажувач проти DOM; пік пам'яті росте монотонно, тому SAX вимірюється першим
+void run_load_benchmark(const std::string& filename) {
+    auto measure = [&](const char* name, void (FlightInformationSystem::*load)(const std::string&)) {
+        FlightInformationSystem fis;
+        auto start = std::chrono::steady_clock::now();
+        (fis.*load)(filename);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << name << ": " << fis.get_table().size() << " flights in " << elapsed.count()
+                  << " s, peak RSS " << peak_rss_mb() << " MB" << std::endl;
+    };
+    measure("SAX", &FlightInformationSystem::read_flights_from_json);
+    measure("DOM", &FlightInformationSystem::read_flights_from_json_dom);
+
+    std::string snapshot = filename + ".snapshot";
+    FlightInformationSystem source;
+    source.read_flights_from_json(filename);
+    source.write_snapshot(snapshot);
+    {
+        FlightInformationSystem fis;
+        auto start = std::chrono::steady_clock::now();
+        fis.load_snapshot(snapshot);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Snapshot: " << fis.get_table().size() << " flights in " << elapsed.count()
+                  << " s, peak RSS " << peak_rss_mb() << " MB" << std::endl;
+    }
+    std::remove(snapshot.c_str());
+}
+
+// Бенчмарк одночасного читання: потоки-читачі виконують запити, поки записувач публікує пакети змін статусу
+void run_concurrency_benchmark(const std::string& filename) {
+    FlightInformationSystem loaded;
+    loaded.read_flights_from_json(filename);
+    FlightStore store(std::move(loaded));
+
+    auto initial = store.snapshot();
+    const FlightTable& table = initial->get_table();
+    if (table.size() == 0) {
+        throw std::runtime_error("No flights in " + filename);
+    }
+    std::vector<std::string> airlines, destinations, numbers;
+    for (std::uint32_t code = 0; code < table.airlines().size(); ++code) {
+        airlines.push_back(table.airlines().decode(code));
+    }
+    for (std::uint32_t code = 0; code < table.destinations().size(); ++code) {
+        destinations.push_back(table.destinations().decode(code));
+    }
+    for (FlightTable::Row row = 0; row < table.size(); ++row) {
+        numbers.emplace_back(table.flight_number(row));
+    }
+    auto first_departure = FlightTable::to_time_point(*std::min_element(table.departure_column().begin(), table.departure_column().end()));
+    initial.reset();
+
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        std::atomic<bool> running(true);
+        std::atomic<std::uint64_t> queries(0);
+        std::atomic<std::uint64_t> rows(0);
+        std::uint64_t start_version = store.current_version();
+
+        std::thread writer([&]() {
+            size_t next = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                store.update([&](FlightInformationSystem& system) {
+                    for (int i = 0; i < 256; ++i, ++next) {
+                        system.update_status(numbers[next % numbers.size()], static_cast<FlightStatus>(next % 5));
+                    }
+                });
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        });
+
+        std::vector<std::thread> readers;
+        for (unsigned t = 0; t < threads; ++t) {
+            readers.emplace_back([&, t]() {
+                FlightStore::Reader reader(store);
+                std::uint64_t local = 0;
+                std::uint64_t matched = 0;
+                for (size_t i = t; running.load(std::memory_order_relaxed); ++i, ++local) {
+                    FlightQueryHandler handler(reader.refresh());
+                    auto start = first_departure + std::chrono::hours(i % 72);
+                    matched += handler.view_flights_by_airline(airlines[i % airlines.size()]).size();
+                    matched += handler.view_delayed_flights().size();
+                    matched += handler.view_flights_in_interval_to_destination(start, start + std::chrono::hours(6), destinations[i % destinations.size()]).size();
+                }
+                queries.fetch_add(local, std::memory_order_relaxed);
+                rows.fetch_add(matched, std::memory_order_relaxed);
+            });
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        running.store(false);
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        writer.join();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+        std::cout << threads << " reader threads: " << static_cast<std::uint64_t>(queries.load() / elapsed.count())
+                  << " queries/s, " << rows.load() / std::max<std::uint64_t>(queries.load(), 1) << " rows/query, "
+                  << store.current_version() - start_version << " versions published" << std::endl;
+    }
+}
+
+// Параметри синтетичного набору рейсів; ті самі параметри і seed дають побайтово той самий файл
+struct DatasetOptions {
+    size_t flights = 10000;
+    std::uint64_t seed = 42;
+    size_t airlines = 20;
+    size_t destinations = 200;
+    // Показник розподілу Ципфа для авіакомпаній і напрямків (0 - рівномірний розподіл)
+    double skew = 1.0;
+    // Відносні частки статусів у порядку FlightStatus: OnTime, Delayed, Cancelled, Boarding, InFlight
+    std::vector<double> status_mix = {60, 15, 5, 10, 10};
+    int days = 30;
+};
+
+// FlightGenerator: детермінований генератор рейсів. Використовує лише mt19937_64 (послідовність
+// визначена стандартом) і власну вибірку, а не std::*_distribution, що відрізняються між бібліотеками
+class FlightGenerator {
+public:
+    explicit FlightGenerator(const DatasetOptions& options)
+        : options(options), random(options.seed), airline_weights(zipf(options.airlines, options.skew)),
+          destination_weights(zipf(options.destinations, options.skew)), status_weights(options.status_mix) {
+        if (options.airlines == 0 || options.destinations == 0 || options.days <= 0 || status_weights.size() != 5) {
+            throw std::invalid_argument("Invalid dataset options");
+        }
+        std::partial_sum(status_weights.begin(), status_weights.end(), status_weights.begin());
+        if (!(status_weights.back() > 0)) {
+            throw std::invalid_argument("Invalid status mix");
+        }
+    }
+
+    Flight next() {
+        static const char* aircraft[] = {"A320", "A321", "B737", "B787", "E190"};
+        static const char* terminals[] = {"A", "B", "C", "D"};
+        static const auto first_day = Flight::parse_date("2024-03-01T00:00:00");
+
+        Flight f;
+        f.FlightNumber = "FN" + std::to_string(generated++);
+        f.Airline = "Airline" + std::to_string(pick(airline_weights) + 1);
+        f.Destination = "City" + std::to_string(pick(destination_weights) + 1);
+        f.DepartureTime = first_day + std::chrono::minutes(static_cast<std::int64_t>(uniform() * options.days * 1440));
+        f.Status = static_cast<FlightStatus>(pick(status_weights));
+        auto duration = std::chrono::minutes(30 + random() % 600);
+        auto delay = std::chrono::minutes(f.Status == FlightStatus::Delayed ? 5 + random() % 240 : 0);
+        f.Duration = duration;
+        f.ArrivalTime = f.DepartureTime + duration + delay;
+        f.Gate = "G" + std::to_string(1 + random() % 60);
+        f.AircraftType = aircraft[random() % 5];
+        f.Terminal = terminals[random() % 4];
+        return f;
+    }
+
+    // Файл пишеться потоково, по одному рейсу, тож і 10M рейсів не потребують DOM у пам'яті
+    void write_json(const std::string& filename) {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file " + filename);
+        }
+        file << "{\"flights\": [";
+        for (size_t i = 0; i < options.flights; ++i) {
+            file << (i == 0 ? "\n" : ",\n") << next().to_json().dump();
+        }
+        file << "\n]}\n";
+        if (!file) {
+            throw std::runtime_error("Could not write file " + filename);
+        }
+    }
+
+private:
+    DatasetOptions options;
+    std::mt19937_64 random;
+    std::vector<double> airline_weights;
+    std::vector<double> destination_weights;
+    std::vector<double> status_weights;
+    size_t generated = 0;
+
+    double uniform() {
+        return static_cast<double>(random() >> 11) * 0x1.0p-53;
+    }
+
+    // Індекс за накопиченими вагами
+    size_t pick(const std::vector<double>& cumulative) {
+        size_t i = std::upper_bound(cumulative.begin(), cumulative.end(), uniform() * cumulative.back()) - cumulative.begin();
+        return std::min(i, cumulative.size() - 1);
+    }
+
+    static std::vector<double> zipf(size_t count, double skew) {
+        std::vector<double> cumulative(count);
+        double total = 0;
+        for (size_t k = 0; k < count; ++k) {
+            total += 1.0 / std::pow(static_cast<double>(k + 1), skew);
+            cumulative[k] = total;
+        }
+        return cumulative;
+    }
+};
+
+// Бенчмарк запитів: для кожного розміру генерується набір, вимірюються завантаження, пік пам'яті
+// та p50/p99 затримки і пропускна здатність кожного методу FlightQueryHandler.
+// Пік RSS не зменшується між розмірами, тому розміри слід задавати за зростанням.
+void run_query_benchmark(const std::vector<size_t>& sizes, const DatasetOptions& base) {
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    for (size_t size : sizes) {
+        DatasetOptions options = base;
+        options.flights = size;
+        std::string filename = "bench_flights_" + std::to_string(size) + ".json";
+        FlightGenerator(options).write_json(filename);
+
+        FlightInformationSystem fis;
+        auto load_start = Clock::now();
+        fis.read_flights_from_json(filename);
+        std::chrono::duration<double> load_time = Clock::now() - load_start;
+        std::remove(filename.c_str());
+        std::cout << size << " flights: load " << load_time.count() << " s, peak RSS " << peak_rss_mb() << " MB" << std::endl;
+
+        const FlightTable& table = fis.get_table();
+        std::vector<std::string> airlines, destinations;
+        for (std::uint32_t code = 0; code < table.airlines().size(); ++code) {
+            airlines.push_back(table.airlines().decode(code));
+        }
+        for (std::uint32_t code = 0; code < table.destinations().size(); ++code) {
+            destinations.push_back(table.destinations().decode(code));
+        }
+        const std::int64_t first_day = Flight::days_from_civil(2024, 3, 1);
+        auto window = [&](size_t i) {
+            return TimePoint(std::chrono::seconds(first_day * 86400)) + std::chrono::minutes(static_cast<std::int64_t>(i * 7919 % (options.days * 1440)));
+        };
+        auto day = [&](size_t i) {
+            std::tm tm = {};
+            Flight::civil_from_days(first_day + static_cast<std::int64_t>(i % options.days), tm.tm_year, tm.tm_mon, tm.tm_mday);
+            tm.tm_year -= 1900;
+            tm.tm_mon -= 1;
+            return tm;
+        };
+
+        FlightQueryHandler handler(fis);
+        std::vector<std::pair<const char*, std::function<size_t(size_t)>>> queries = {
+            {"get_flights_by_airline", [&](size_t i) { return handler.get_flights_by_airline(airlines[i % airlines.size()]).size(); }},
+            {"get_delayed_flights", [&](size_t) { return handler.get_delayed_flights().size(); }},
+            {"get_delayed_flights(ByDelay)", [&](size_t) { return handler.get_delayed_flights(DelayedOrder::ByDelay).size(); }},
+            {"get_flights_by_day", [&](size_t i) { return handler.get_flights_by_day(day(i)).size(); }},
+            {"get_flights_in_interval_to_destination", [&](size_t i) {
+                return handler.get_flights_in_interval_to_destination(window(i), window(i) + std::chrono::hours(24), destinations[i % destinations.size()]).size();
+            }},
+            {"get_flights_arriving_recently_or_interval", [&](size_t i) {
+                return handler.get_flights_arriving_recently_or_interval(window(i), window(i) + std::chrono::hours(1)).size();
+            }},
+            {"view_flights_by_airline", [&](size_t i) { return handler.view_flights_by_airline(airlines[i % airlines.size()]).size(); }},
+            {"view_delayed_flights", [&](size_t) { return handler.view_delayed_flights().size(); }},
+            {"view_flights_by_day", [&](size_t i) { return handler.view_flights_by_day(day(i)).size(); }},
+            {"view_flights_in_interval_to_destination", [&](size_t i) {
+                return handler.view_flights_in_interval_to_destination(window(i), window(i) + std::chrono::hours(24), destinations[i % destinations.size()]).size();
+            }},
+            {"view_flights_arriving_recently_or_interval", [&](size_t i) {
+                return handler.view_flights_arriving_recently_or_interval(window(i), window(i) + std::chrono::hours(1)).size();
+            }},
+            {"view_next_departures(10)", [&](size_t i) { return handler.view_next_departures(window(i), 10).size(); }},
+            {"view_next_departures(10, airline)", [&](size_t i) {
+                return handler.view_next_departures(window(i), 10, airlines[i % airlines.size()]).size();
+            }},
+            {"view_most_delayed(10)", [&](size_t) { return handler.view_most_delayed(10).size(); }},
+            {"count_by_airline", [&](size_t i) { return handler.count_by_airline(window(i), window(i) + std::chrono::hours(24)).size(); }},
+            {"count_by_destination", [&](size_t i) { return handler.count_by_destination(window(i), window(i) + std::chrono::hours(24)).size(); }},
+            {"count_by_status", [&](size_t i) { return handler.count_by_status(window(i), window(i) + std::chrono::hours(24)).size(); }},
+            {"top_destinations(10)", [&](size_t) { return handler.top_destinations(10).size(); }},
+            {"delay_histogram", [&](size_t) { return handler.delay_histogram(std::chrono::minutes(15), 16).size(); }},
+        };
+
+        // Кожен метод виконується до 1000 разів або ~1 с, але щонайменше 3 рази
+        for (const auto& query : queries) {
+            std::vector<double> latencies;
+            size_t rows = 0;
+            auto started = Clock::now();
+            for (size_t i = 0; i < 1000 && (latencies.size() < 3 || Clock::now() - started < std::chrono::seconds(1)); ++i) {
+                auto start = Clock::now();
+                rows += query.second(i);
+                latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            }
+            std::chrono::duration<double> total = Clock::now() - started;
+            std::sort(latencies.begin(), latencies.end());
+            double p50 = latencies[latencies.size() / 2];
+            double p99 = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+            std::cout << "  " << std::left << std::setw(44) << query.first << std::right
+                      << " p50 " << std::setw(10) << p50 << " us, p99 " << std::setw(10) << p99 << " us, "
+                      << std::setw(10) << static_cast<std::uint64_t>(latencies.size() / total.count()) << " queries/s, "
+                      << rows / latencies.size() << " rows/query" << std::endl;
+        }
+    }
+}
+
+// Аргументи генератора і бенчмарку: числа - кількості рейсів, решта у вигляді key=value
+// (seed, airlines, destinations, skew, days, status=OnTime,Delayed,Cancelled,Boarding,InFlight)
+DatasetOptions parse_dataset_options(int argc, char* argv[], int first, std::vector<size_t>& counts) {
+    DatasetOptions options;
+    for (int i = first; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq == std::string::npos) {
+            counts.push_back(std::stoull(arg));
+            continue;
+        }
+        std::string key = arg.substr(0, eq);
+        std::string value = arg.substr(eq + 1);
+        if (key == "seed") options.seed = std::stoull(value);
+        else if (key == "airlines") options.airlines = std::stoull(value);
+        else if (key == "destinations") options.destinations = std::stoull(value);
+        else if (key == "skew") options.skew = std::stod(value);
+        else if (key == "days") options.days = std::stoi(value);
+        else if (key == "status") {
+            options.status_mix.clear();
+            std::stringstream parts(value);
+            std::string part;
+            while (std::getline(parts, part, ',')) {
+                options.status_mix.push_back(std::stod(part));
+            }
+        } else {
+            throw std::invalid_argument("Unknown option " + key);
+        }
+    }
+    return options;
+}
+
+// Знімок використовується, якщо він записаний з JSON того самого розміру й часу зміни
+// (або JSON недоступний); інакше JSON розбирається і знімок оновлюється
+void load_flights(FlightInformationSystem& fis, const std::string& json_file, const std::string& snapshot_file) {
+    std::error_code json_error, snapshot_error;
+    SnapshotSource source = SnapshotSource::of(json_file, json_error);
+    if (std::filesystem::exists(snapshot_file, snapshot_error)) {
+        try {
+            fis.load_snapshot(snapshot_file, json_error ? nullptr : &source);
+            return;
+        } catch (const std::runtime_error& e) {
+            std::cerr << e.what() << ", falling back to " << json_file << std::endl;
+        }
+    }
+    fis.read_flights_from_json(json_file);
+    // Знімок лише прискорює наступний запуск, тож помилка запису не зупиняє програму
+    try {
+        fis.write_snapshot(snapshot_file, source);
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << ", snapshot not saved" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && std::string(argv[1]) == "--bench-load") {
+        run_load_benchmark(argv[2]);
+        return 0;
+    }
+    if (argc > 2 && std::string(argv[1]) == "--bench-concurrent") {
+        run_concurrency_benchmark(argv[2]);
+        return 0;
+    }
+    // lab_6 --generate flights.json 100000 [seed=42 skew=1.0 status=60,15,5,10,10 ...]
+    if (argc > 2 && std::string(argv[1]) == "--generate") {
+        std::vector<size_t> counts;
+        DatasetOptions options = parse_dataset_options(argc, argv, 3, counts);
+        if (!counts.empty()) {
+            options.flights = counts.front();
+        }
+        FlightGenerator(options).write_json(argv[2]);
+        return 0;
+    }
+    // lab_6 --bench [10000 1000000 10000000] [key=value ...]
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        std::vector<size_t> sizes;
+        DatasetOptions options = parse_dataset_options(argc, argv, 2, sizes);
+        if (sizes.empty()) {
+            sizes = {10000, 1000000, 10000000};
+        }
+        run_query_benchmark(sizes, options);
+        return 0;
+    }
+
+    FlightInformationSystem fis;
+    load_flights(fis, "flights.json", "flights.snapshot");
+
+    // Потік оновлень з файлу або каналу: lab_6 --updates events.ndjson
+    if (argc > 2 && std::string(argv[1]) == "--updates") {
+        size_t applied = fis.apply_updates(argv[2]);
+        std::cerr << applied << " updates applied" << std::endl;
+    }
 
     FlightQueryHandler handler(fis);
 
     // Приклад використання:
-    auto flights = handler.get_flights_by_airline("WizAir");
-    for (const auto& flight : flights) {
+    for (FlightRef flight : handler.view_flights_by_airline("WizAir")) {
         std::cout << flight.to_json().dump(4) << std::endl;
     }
 